@@ -2,5 +2,7 @@ import FWCore.ParameterSet.Config as cms
 
 
 eventAuxiliaryHistoryProducer = cms.EDProducer("EventAuxiliaryHistoryProducer",
-    historyDepth = cms.uint32(5)
+    historyDepth = cms.uint32(5),
+    storeEventAuxiliary = cms.bool(True),
+    columns = cms.vstring()
 )
@@ -2,5 +2,8 @@ import FWCore.ParameterSet.Config as cms
 
 preScaler = cms.EDFilter("Prescaler",
                          prescaleFactor = cms.int32(1),
-                         prescaleOffset = cms.int32(0)
+                         prescaleOffset = cms.int32(0),
+                         useEventIDHash = cms.bool(False),
+                         hashSeed = cms.uint32(0),
+                         prescaleTable = cms.VPSet()
                          )
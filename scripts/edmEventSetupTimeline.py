@@ -0,0 +1,54 @@
+#!/usr/bin/env python
+#
+# Summarizes a timeline file written by PrintEventSetupContent with its
+# 'timelineFile' parameter: the number of IOVs seen for each record and
+# the records whose IOV changes more often than expected.
+#
+import sys
+from optparse import OptionParser
+
+def readTimeline(fileName):
+    """returns a dictionary record name -> set of (cacheIdentifier, IOV start, IOV end)
+    and the sets of runs and luminosity blocks seen in the file"""
+    iovs = {}
+    runs = set()
+    lumis = set()
+    for line in open(fileName):
+        if line.startswith('#') or not line.strip():
+            continue
+        fields = line.rstrip('\n').split('\t')
+        if len(fields) < 14:
+            raise RuntimeError("malformed line in %s: %s" % (fileName, line))
+        transition, run, lumi, event, record = fields[0:5]
+        runs.add(run)
+        if transition != 'beginRun':
+            lumis.add((run, lumi))
+        iovs.setdefault(record, set()).add((fields[13], tuple(fields[5:9]), tuple(fields[9:13])))
+    return iovs, runs, lumis
+
+def main():
+    parser = OptionParser(usage="%prog [options] timelineFile")
+    parser.add_option("--maxIOVsPerRun", type="float", default=1.0,
+                      help="report records with more IOVs per run than this [default: %default]")
+    (options, args) = parser.parse_args()
+    if len(args) != 1:
+        parser.error("exactly one timeline file is needed")
+
+    iovs, runs, lumis = readTimeline(args[0])
+    nRuns = max(len(runs), 1)
+    print("%d runs, %d luminosity blocks" % (len(runs), len(lumis)))
+    print("%-50s %8s %12s" % ("record", "IOVs", "IOVs/run"))
+    churning = []
+    for record, entries in sorted(iovs.items(), key=lambda item: -len(item[1])):
+        perRun = float(len(entries)) / nRuns
+        print("%-50s %8d %12.2f" % (record, len(entries), perRun))
+        if perRun > options.maxIOVsPerRun:
+            churning.append(record)
+    if churning:
+        print("\nRecords with more than %g IOVs per run:" % options.maxIOVsPerRun)
+        for record in churning:
+            print("  %s" % record)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,13 +1,149 @@
-#include <set>
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
 #include "FWCore/Framework/interface/SourceFactory.h"
+#include "MappedFile.h"
 
 namespace edm {
-   
+
+namespace {
+//The IOVs of one schedule, shared by all the records configured to use it
+class IOVSchedule {
+   public:
+      IOVSchedule(ParameterSet const& pset);
+
+      void intervalFor(IOVSyncValue const& iTime, ValidityInterval& oInterval);
+
+   private:
+      bool contains(unsigned int iIndex, IOVSyncValue const& iTime) const;
+
+      //sorted and unique starts of the IOVs and the matching ends
+      std::vector<IOVSyncValue> startOfIOV_;
+      std::vector<IOVSyncValue> endOfIOV_;
+      //index of the IOV found by the previous call, usually the next call wants the same or the following one
+      unsigned int lastIndex_;
+      //all the records sharing this schedule are asked for the same sync value in a row
+      IOVSyncValue lastTime_;
+      ValidityInterval lastInterval_;
+      bool iovIsTime_;
+};
+
+IOVSchedule::IOVSchedule(ParameterSet const& pset) :
+     lastIndex_(0),
+     lastTime_(IOVSyncValue::invalidIOVSyncValue()),
+     lastInterval_(ValidityInterval::invalidInterval()),
+     iovIsTime_(!pset.getParameter<bool>("iovIsRunNotTime")) {
+   std::vector<unsigned int> temp(pset.getParameter< std::vector<unsigned int> >("firstValid"));
+   std::vector<unsigned int> lumis;
+   if(pset.existsAs<std::vector<unsigned int> >("firstValidLuminosityBlock")) {
+      lumis = pset.getParameter<std::vector<unsigned int> >("firstValidLuminosityBlock");
+      if(iovIsTime_ || lumis.size() != temp.size()) {
+         throw edm::Exception(errors::Configuration) << "EmptyESSource: 'firstValidLuminosityBlock' can only be used with 'iovIsRunNotTime' set to true "
+         << "and must have as many entries as 'firstValid'.";
+      }
+   }
+   startOfIOV_.reserve(temp.size());
+   for(std::vector<unsigned int>::iterator itValue = temp.begin(), itValueEnd = temp.end();
+        itValue != itValueEnd;
+        ++itValue) {
+      if(iovIsTime_) {
+         startOfIOV_.push_back(IOVSyncValue(Timestamp(*itValue)));
+      } else {
+         startOfIOV_.push_back(IOVSyncValue(EventID(*itValue, lumis.empty() ? 0 : lumis[itValue - temp.begin()], 0)));
+      }
+   }
+   if(pset.existsAs<std::string>("firstValidFile")) {
+      //binary file of native 64 bit timestamps, or of pairs of native 32 bit run and luminosity block numbers
+      std::string const fileName = pset.getParameter<std::string>("firstValidFile");
+      MappedFile file(fileName);
+      size_t const recordSize = iovIsTime_ ? sizeof(unsigned long long) : 2 * sizeof(unsigned int);
+      if(file.size() % recordSize != 0) {
+         throw edm::Exception(errors::Configuration) << "EmptyESSource: the size of the IOV file \"" << fileName
+         << "\" is not a multiple of " << recordSize << " bytes.";
+      }
+      size_t const nRecords = file.size() / recordSize;
+      startOfIOV_.reserve(startOfIOV_.size() + nRecords);
+      if(iovIsTime_) {
+         unsigned long long const* values = reinterpret_cast<unsigned long long const*>(file.begin());
+         for(size_t i = 0; i != nRecords; ++i) {
+            startOfIOV_.push_back(IOVSyncValue(Timestamp(values[i])));
+         }
+      } else {
+         unsigned int const* values = reinterpret_cast<unsigned int const*>(file.begin());
+         for(size_t i = 0; i != nRecords; ++i) {
+            startOfIOV_.push_back(IOVSyncValue(EventID(values[2 * i], values[2 * i + 1], 0)));
+         }
+      }
+   }
+   //a sorted input, the expected case for big files, needs no sorting
+   if(!std::is_sorted(startOfIOV_.begin(), startOfIOV_.end())) {
+      std::sort(startOfIOV_.begin(), startOfIOV_.end());
+   }
+   startOfIOV_.erase(std::unique(startOfIOV_.begin(), startOfIOV_.end()), startOfIOV_.end());
+
+   //each IOV ends just before the next one starts
+   endOfIOV_.reserve(startOfIOV_.size());
+   for(unsigned int next = 1; next < startOfIOV_.size(); ++next) {
+      if(iovIsTime_) {
+         endOfIOV_.push_back(IOVSyncValue(Timestamp(startOfIOV_[next].time().value() - 1)));
+      } else {
+         EventID const& nextStart = startOfIOV_[next].eventID();
+         if(0 == nextStart.luminosityBlock()) {
+            endOfIOV_.push_back(IOVSyncValue(nextStart.previousRunLastEvent(0)));
+         } else {
+            endOfIOV_.push_back(IOVSyncValue(EventID(nextStart.run(), nextStart.luminosityBlock() - 1, EventID::maxEventNumber())));
+         }
+      }
+   }
+   if(!startOfIOV_.empty()) {
+      endOfIOV_.push_back(IOVSyncValue::endOfTime());
+   }
+}
+
+bool
+IOVSchedule::contains(unsigned int iIndex, IOVSyncValue const& iTime) const {
+   return iIndex < startOfIOV_.size() &&
+          !(iTime < startOfIOV_[iIndex]) &&
+          (iIndex + 1 == startOfIOV_.size() || iTime < startOfIOV_[iIndex + 1]);
+}
+
+void
+IOVSchedule::intervalFor(IOVSyncValue const& iTime, ValidityInterval& oInterval) {
+   if(iTime == lastTime_) {
+      oInterval = lastInterval_;
+      return;
+   }
+   lastTime_ = iTime;
+   lastInterval_ = ValidityInterval::invalidInterval();
+   oInterval = lastInterval_;
+   //if no intervals given, fail immediately
+   if (startOfIOV_.empty()) {
+      return;
+   }
+
+   unsigned int index = lastIndex_;
+   if(!contains(index, iTime)) {
+      if(contains(index + 1, iTime)) {
+         ++index;
+      } else {
+         std::vector<IOVSyncValue>::const_iterator itFound = std::upper_bound(startOfIOV_.begin(), startOfIOV_.end(), iTime);
+         if(itFound == startOfIOV_.begin()) {
+            //request is before first valid interval, so fail
+            return;
+         }
+         index = (itFound - startOfIOV_.begin()) - 1;
+      }
+      lastIndex_ = index;
+   }
+   lastInterval_ = ValidityInterval(startOfIOV_[index], endOfIOV_[index]);
+   oInterval = lastInterval_;
+}
+}
+
 class EmptyESSource : public  EventSetupRecordIntervalFinder {
 
    public:
@@ -20,87 +156,79 @@ class EmptyESSource : public  EventSetupRecordIntervalFinder {
 
       // ---------- member functions ---------------------------
    void setIntervalFor(eventsetup::EventSetupRecordKey const&,
-                        IOVSyncValue const& iTime, 
+                        IOVSyncValue const& iTime,
                         ValidityInterval& oInterval);
-      
+
    private:
       EmptyESSource(EmptyESSource const&); // stop default
 
       EmptyESSource const& operator=(EmptyESSource const&); // stop default
-      
+
       void delaySettingRecords();
       // ---------- member data --------------------------------
-      std::string recordName_;
-      std::set <IOVSyncValue> setOfIOV_;
-      bool iovIsTime_;
+      //record name and the index of its schedule in schedules_
+      std::vector<std::pair<std::string, unsigned int> > recordNames_;
+      std::vector<IOVSchedule> schedules_;
+      //record key and the index of its schedule, only a few entries so a linear search beats a map
+      std::vector<std::pair<eventsetup::EventSetupRecordKey, unsigned int> > recordToSchedule_;
 };
 
-EmptyESSource::EmptyESSource(ParameterSet const& pset) :
-     recordName_(pset.getParameter<std::string>("recordName")),
-     iovIsTime_(!pset.getParameter<bool>("iovIsRunNotTime")) {
-   std::vector<unsigned int> temp(pset.getParameter< std::vector<unsigned int> >("firstValid"));
-   for(std::vector<unsigned int>::iterator itValue = temp.begin(), itValueEnd = temp.end();
-        itValue != itValueEnd;
-        ++itValue) {
-      if(iovIsTime_) {
-         setOfIOV_.insert(IOVSyncValue(Timestamp(*itValue)));
-      } else {
-         setOfIOV_.insert(IOVSyncValue(EventID(*itValue, 0, 0)));
+EmptyESSource::EmptyESSource(ParameterSet const& pset) {
+   //the top level schedule is used by 'recordName' and all of 'additionalRecordNames'
+   schedules_.push_back(IOVSchedule(pset));
+   recordNames_.push_back(std::make_pair(pset.getParameter<std::string>("recordName"), 0U));
+   if(pset.existsAs<std::vector<std::string> >("additionalRecordNames")) {
+      std::vector<std::string> const names(pset.getParameter<std::vector<std::string> >("additionalRecordNames"));
+      for(std::vector<std::string>::const_iterator itName = names.begin(), itNameEnd = names.end();
+           itName != itNameEnd;
+           ++itName) {
+         recordNames_.push_back(std::make_pair(*itName, 0U));
+      }
+   }
+   //each entry of 'records' has its own schedule
+   if(pset.existsAs<std::vector<ParameterSet> >("records")) {
+      std::vector<ParameterSet> const& records = pset.getParameterSetVector("records");
+      for(std::vector<ParameterSet>::const_iterator itRecord = records.begin(), itRecordEnd = records.end();
+           itRecord != itRecordEnd;
+           ++itRecord) {
+         recordNames_.push_back(std::make_pair(itRecord->getParameter<std::string>("recordName"), static_cast<unsigned int>(schedules_.size())));
+         schedules_.push_back(IOVSchedule(*itRecord));
       }
    }
-   //copy_all(temp, inserter(setOfIOV_ , setOfIOV_.end()));
 }
-  
-   
-void 
+
+
+void
 EmptyESSource::delaySettingRecords() {
-   eventsetup::EventSetupRecordKey recordKey = eventsetup::EventSetupRecordKey::TypeTag::findType(recordName_);
-   if (recordKey == eventsetup::EventSetupRecordKey()) {
-      throw edm::Exception(errors::Configuration) << " The Record type named \"" << recordName_
-      << "\" could not be found. Please check the spelling. \n"
-      << "If the spelling is fine, then no module in the job requires this Record and therefore EmptyESSource can not function.\n"
-      "In such a case please either remove the EmptyESSource with label'"
-      << descriptionForFinder().label_ << "' from your job or add a module which needs the Record to your job.";
+   for(std::vector<std::pair<std::string, unsigned int> >::const_iterator itName = recordNames_.begin(), itNameEnd = recordNames_.end();
+        itName != itNameEnd;
+        ++itName) {
+      eventsetup::EventSetupRecordKey recordKey = eventsetup::EventSetupRecordKey::TypeTag::findType(itName->first);
+      if (recordKey == eventsetup::EventSetupRecordKey()) {
+         throw edm::Exception(errors::Configuration) << " The Record type named \"" << itName->first
+         << "\" could not be found. Please check the spelling. \n"
+         << "If the spelling is fine, then no module in the job requires this Record and therefore EmptyESSource can not function.\n"
+         "In such a case please either remove the EmptyESSource with label'"
+         << descriptionForFinder().label_ << "' from your job or add a module which needs the Record to your job.";
+      }
+      recordToSchedule_.push_back(std::make_pair(recordKey, itName->second));
+      findingRecordWithKey(recordKey);
    }
-   findingRecordWithKey(recordKey);
 }
 
-void 
-EmptyESSource::setIntervalFor(eventsetup::EventSetupRecordKey const&,
-                               IOVSyncValue const& iTime, 
+void
+EmptyESSource::setIntervalFor(eventsetup::EventSetupRecordKey const& iKey,
+                               IOVSyncValue const& iTime,
                                ValidityInterval& oInterval) {
    oInterval = ValidityInterval::invalidInterval();
-   //if no intervals given, fail immediately
-   if (setOfIOV_.size() == 0) {
-      return;
-   }
-   
-   std::pair< std::set<IOVSyncValue>::iterator, 
-      std::set<IOVSyncValue>::iterator > itFound = setOfIOV_.equal_range(iTime);
-   
-   //we have overshot
-   if(itFound.first == itFound.second) {
-      if(itFound.first == setOfIOV_.begin()) {
-         //request is before first valid interval, so fail
+   for(std::vector<std::pair<eventsetup::EventSetupRecordKey, unsigned int> >::const_iterator itRecord = recordToSchedule_.begin(), itRecordEnd = recordToSchedule_.end();
+        itRecord != itRecordEnd;
+        ++itRecord) {
+      if(itRecord->first == iKey) {
+         schedules_[itRecord->second].intervalFor(iTime, oInterval);
          return;
       }
-      //go back one step
-      --itFound.first;
-   }
-   if (itFound.first == setOfIOV_.end()) {
-      return;
-   }
-   
-   IOVSyncValue endOfInterval = IOVSyncValue::endOfTime();
-   
-   if(itFound.second != setOfIOV_.end()) {
-      if(iovIsTime_) {
-         endOfInterval = IOVSyncValue(Timestamp(itFound.second->time().value() - 1));
-      } else {
-         endOfInterval = IOVSyncValue(itFound.second->eventID().previousRunLastEvent(0));
-      }
    }
-   oInterval = ValidityInterval(*(itFound.first), endOfInterval);
 }
 
 }
@@ -1,8 +1,15 @@
 #include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/InputSourceDescription.h"
 #include "FWCore/Framework/interface/InputSourceMacros.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
 #include "FWCore/Sources/interface/ProducerSourceBase.h"
+#include "FWCore/Utilities/interface/CPUTimer.h"
+
+#include <iomanip>
 
 namespace edm {
   class EmptySource : public ProducerSourceBase {
@@ -11,14 +18,58 @@ namespace edm {
     ~EmptySource();
     static void fillDescriptions(ConfigurationDescriptions& descriptions);
   private:
+    enum Transition { kBeginRun, kEndRun, kBeginLumi, kEndLumi, kEvent, kNTransitions };
+
     virtual bool setRunAndEventInfo(EventID& id, TimeValue_t& time);
     virtual void produce(Event &);
+
+    // used by 'reportTransitionTimes' to time each framework transition
+    void startTransition() { timer_.reset(); timer_.start(); }
+    void endTransition(Transition iTransition) {
+      timer_.stop();
+      totalTime_[iTransition] += timer_.realTime();
+      ++count_[iTransition];
+    }
+    void preBeginRun(RunID const&, Timestamp const&) { startTransition(); }
+    void postBeginRun(Run const&, EventSetup const&) { endTransition(kBeginRun); }
+    void preEndRun(RunID const&, Timestamp const&) { startTransition(); }
+    void postEndRun(Run const&, EventSetup const&) { endTransition(kEndRun); }
+    void preBeginLumi(LuminosityBlockID const&, Timestamp const&) { startTransition(); }
+    void postBeginLumi(LuminosityBlock const&, EventSetup const&) { endTransition(kBeginLumi); }
+    void preEndLumi(LuminosityBlockID const&, Timestamp const&) { startTransition(); }
+    void postEndLumi(LuminosityBlock const&, EventSetup const&) { endTransition(kEndLumi); }
+    void preProcessEvent(EventID const&, Timestamp const&) { startTransition(); }
+    void postProcessEvent(Event const&, EventSetup const&) { endTransition(kEvent); }
+    void postEndJob();
+
+    CPUTimer timer_;
+    double totalTime_[kNTransitions];
+    unsigned long long count_[kNTransitions];
   };
 
   EmptySource::EmptySource(ParameterSet const& pset,
 				       InputSourceDescription const& desc) :
-    ProducerSourceBase(pset, desc, false)
-  { }
+    ProducerSourceBase(pset, desc, false),
+    timer_() {
+    for(unsigned int i = 0; i != kNTransitions; ++i) {
+      totalTime_[i] = 0.;
+      count_[i] = 0;
+    }
+    if(pset.getUntrackedParameter<bool>("reportTransitionTimes")) {
+      ActivityRegistry& registry = *desc.actReg_;
+      registry.watchPreBeginRun(this, &EmptySource::preBeginRun);
+      registry.watchPostBeginRun(this, &EmptySource::postBeginRun);
+      registry.watchPreEndRun(this, &EmptySource::preEndRun);
+      registry.watchPostEndRun(this, &EmptySource::postEndRun);
+      registry.watchPreBeginLumi(this, &EmptySource::preBeginLumi);
+      registry.watchPostBeginLumi(this, &EmptySource::postBeginLumi);
+      registry.watchPreEndLumi(this, &EmptySource::preEndLumi);
+      registry.watchPostEndLumi(this, &EmptySource::postEndLumi);
+      registry.watchPreProcessEvent(this, &EmptySource::preProcessEvent);
+      registry.watchPostProcessEvent(this, &EmptySource::postProcessEvent);
+      registry.watchPostEndJob(this, &EmptySource::postEndJob);
+    }
+  }
 
   EmptySource::~EmptySource() {
   }
@@ -32,10 +83,26 @@ namespace edm {
   EmptySource::produce(edm::Event&) {
   }
 
+  void
+  EmptySource::postEndJob() {
+    char const* const names[kNTransitions] = {"beginRun", "endRun", "beginLuminosityBlock", "endLuminosityBlock", "event"};
+    LogSystem log("EmptySourceTransitions");
+    log << "Wall time spent in each transition\n"
+        << std::setw(22) << "transition" << std::setw(12) << "count" << std::setw(14) << "total [s]" << std::setw(14) << "mean [us]" << "\n";
+    for(unsigned int i = 0; i != kNTransitions; ++i) {
+      log << std::setw(22) << names[i] << std::setw(12) << count_[i] << std::setw(14) << totalTime_[i]
+          << std::setw(14) << (count_[i] ? totalTime_[i] / count_[i] * 1e6 : 0.) << "\n";
+    }
+  }
+
   void
   EmptySource::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
     desc.setComment("Creates runs, lumis and events containing no products.");
+    desc.addUntracked<bool>("reportTransitionTimes", false)->setComment("At the end of the job, report the number of begin/end run, begin/end luminosity block "
+                                                                       "and event transitions and the wall time the framework spent in each kind. "
+                                                                       "Combined with 'numberEventsInRun' and 'numberEventsInLuminosityBlock' this measures "
+                                                                       "the framework's transition overhead without any I/O.");
     ProducerSourceBase::fillDescription(desc);
     descriptions.add("source", desc);
   }
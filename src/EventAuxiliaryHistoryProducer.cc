@@ -5,10 +5,31 @@
 #include "FWCore/Framework/interface/Event.h"
 #include "DataFormats/Provenance/interface/EventAuxiliary.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include <algorithm>
 #include <deque>
+#include <string>
+#include <vector>
+
+// The whole history is put into each event since a product can not refer to the products
+// of earlier events, and no new dictionary can be added here for a delta format. Readers
+// which need only some fields can select the smaller 'columns' products instead.
 
 namespace edm {
 
+  namespace {
+    // Columns which can be stored as separate packed vectors, the name is the product instance label
+    enum Column { kRun, kLuminosityBlock, kEvent, kTime, kBunchCrossing, kOrbitNumber, kNColumns };
+    char const* const kColumnNames[kNColumns] = {"run", "luminosityBlock", "event", "time", "bunchCrossing", "orbitNumber"};
+
+    RunNumber_t getRun(EventAuxiliary const& iAux) { return iAux.run(); }
+    LuminosityBlockNumber_t getLuminosityBlock(EventAuxiliary const& iAux) { return iAux.luminosityBlock(); }
+    EventNumber_t getEvent(EventAuxiliary const& iAux) { return iAux.event(); }
+    TimeValue_t getTime(EventAuxiliary const& iAux) { return iAux.time().value(); }
+    int getBunchCrossing(EventAuxiliary const& iAux) { return iAux.bunchCrossing(); }
+    int getOrbitNumber(EventAuxiliary const& iAux) { return iAux.orbitNumber(); }
+  }
+
   class EventAuxiliaryHistoryProducer : public EDProducer {
   public:
     explicit EventAuxiliaryHistoryProducer(ParameterSet const&);
@@ -19,19 +40,64 @@ namespace edm {
     void endJob();
 
   private:
+    template<typename T>
+    void putColumn(Event& e, Column iColumn, T (*iGetter)(EventAuxiliary const&)) const;
+
     unsigned int depth_;
-    std::deque<EventAuxiliary> history_; 
+    std::deque<EventAuxiliary> history_;
+    bool storeEventAuxiliary_;
+    std::vector<Column> columns_;
   };
 
   EventAuxiliaryHistoryProducer::EventAuxiliaryHistoryProducer(ParameterSet const& ps):
     depth_(ps.getParameter<unsigned int>("historyDepth")),
-    history_() {
-      produces<std::vector<EventAuxiliary> > ();
+    history_(),
+    storeEventAuxiliary_(ps.getParameter<bool>("storeEventAuxiliary")),
+    columns_() {
+      if(storeEventAuxiliary_) {
+        produces<std::vector<EventAuxiliary> > ();
+      }
+      std::vector<std::string> const columnNames = ps.getParameter<std::vector<std::string> >("columns");
+      for(std::vector<std::string>::const_iterator it = columnNames.begin(), itEnd = columnNames.end(); it != itEnd; ++it) {
+        Column column = kNColumns;
+        for(unsigned int i = 0; i != kNColumns; ++i) {
+          if(*it == kColumnNames[i]) {
+            column = static_cast<Column>(i);
+          }
+        }
+        if(column == kNColumns) {
+          throw edm::Exception(errors::Configuration) << "EventAuxiliaryHistoryProducer: unknown column \"" << *it << "\" in 'columns'.\n"
+            << "Allowed values are run, luminosityBlock, event, time, bunchCrossing and orbitNumber.\n";
+        }
+        if(std::find(columns_.begin(), columns_.end(), column) != columns_.end()) {
+          continue;
+        }
+        columns_.push_back(column);
+        switch(column) {
+          case kRun: produces<std::vector<RunNumber_t> >(kColumnNames[column]); break;
+          case kLuminosityBlock: produces<std::vector<LuminosityBlockNumber_t> >(kColumnNames[column]); break;
+          case kEvent: produces<std::vector<EventNumber_t> >(kColumnNames[column]); break;
+          case kTime: produces<std::vector<TimeValue_t> >(kColumnNames[column]); break;
+          case kBunchCrossing:
+          case kOrbitNumber: produces<std::vector<int> >(kColumnNames[column]); break;
+          case kNColumns: break;
+        }
+      }
   }
 
   EventAuxiliaryHistoryProducer::~EventAuxiliaryHistoryProducer() {
   }
 
+  template<typename T>
+  void EventAuxiliaryHistoryProducer::putColumn(Event& e, Column iColumn, T (*iGetter)(EventAuxiliary const&)) const {
+    std::auto_ptr<std::vector<T> > result(new std::vector<T>);
+    result->reserve(history_.size());
+    for(std::deque<EventAuxiliary>::const_iterator it = history_.begin(), itEnd = history_.end(); it != itEnd; ++it) {
+      result->push_back(iGetter(*it));
+    }
+    e.put(result, kColumnNames[iColumn]);
+  }
+
   void EventAuxiliaryHistoryProducer::produce(Event& e, EventSetup const&) {
     EventAuxiliary aux(e.id(), "", e.time(), e.isRealData(), e.experimentType(),
                        e.bunchCrossing(), EventAuxiliary::invalidStoreNumber, e.orbitNumber()); 
@@ -44,11 +110,23 @@ namespace edm {
     history_.push_back(aux);
 
     //Serialize into std::vector 
-    std::auto_ptr<std::vector<EventAuxiliary > > result(new std::vector<EventAuxiliary>);
-    for(size_t j = 0; j < history_.size(); ++j) { 
-      result->push_back(history_[j]);
+    if(storeEventAuxiliary_) {
+      std::auto_ptr<std::vector<EventAuxiliary > > result(new std::vector<EventAuxiliary>(history_.begin(), history_.end()));
+      e.put(result);
+    }
+
+    //and each selected field into its own packed vector, also oldest first
+    for(std::vector<Column>::const_iterator it = columns_.begin(), itEnd = columns_.end(); it != itEnd; ++it) {
+      switch(*it) {
+        case kRun: putColumn(e, *it, &getRun); break;
+        case kLuminosityBlock: putColumn(e, *it, &getLuminosityBlock); break;
+        case kEvent: putColumn(e, *it, &getEvent); break;
+        case kTime: putColumn(e, *it, &getTime); break;
+        case kBunchCrossing: putColumn(e, *it, &getBunchCrossing); break;
+        case kOrbitNumber: putColumn(e, *it, &getOrbitNumber); break;
+        case kNColumns: break;
+      }
     }
-    e.put(result);
   }
 
   void EventAuxiliaryHistoryProducer::endJob() {
@@ -59,6 +137,9 @@ namespace edm {
   EventAuxiliaryHistoryProducer::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
     desc.add<unsigned int>("historyDepth");
+    desc.add<bool>("storeEventAuxiliary", true)->setComment("Put the history as a std::vector<EventAuxiliary>.");
+    desc.add<std::vector<std::string> >("columns", std::vector<std::string>())->setComment("Fields of the history to also put as separate vectors, one per field, using the field name as product instance name. "
+                                                                                          "Allowed values are run, luminosityBlock, event, time, bunchCrossing and orbitNumber.");
     descriptions.add("eventAuxiliaryHistory", desc);
   }
 }
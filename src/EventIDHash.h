@@ -0,0 +1,49 @@
+#ifndef FWCore_Modules_EventIDHash_h
+#define FWCore_Modules_EventIDHash_h
+// -*- C++ -*-
+//
+// Package:     Modules
+// Class  :     EventIDHash
+//
+/**\class EventIDHash EventIDHash.h FWCore/Modules/src/EventIDHash.h
+
+ Description: Fast, well mixed hash of an EventID and a seed
+
+ Usage:
+    Used by modules which need a decision per event which only depends on the
+    event's identity, e.g. to select the same events whatever the number of
+    processes or the order in which events are processed.
+*/
+//
+
+// system include files
+
+// user include files
+#include "DataFormats/Provenance/interface/EventID.h"
+
+namespace edm {
+  namespace eventidhash {
+    // finalizer of MurmurHash3, every input bit affects every output bit
+    inline unsigned long long mix(unsigned long long iValue) {
+      iValue ^= iValue >> 33;
+      iValue *= 0xff51afd7ed558ccdULL;
+      iValue ^= iValue >> 33;
+      iValue *= 0xc4ceb9fe1a85ec53ULL;
+      iValue ^= iValue >> 33;
+      return iValue;
+    }
+  }
+
+  inline unsigned long long hashEventID(EventID const& iID, unsigned long long iSeed) {
+    unsigned long long value = eventidhash::mix(iSeed ^ iID.run());
+    value = eventidhash::mix(value ^ iID.luminosityBlock());
+    return eventidhash::mix(value ^ iID.event());
+  }
+
+  // uniformly distributed in [0,1), built from the top 53 bits of the hash
+  inline double uniformFromEventID(EventID const& iID, unsigned long long iSeed) {
+    return (hashEventID(iID, iSeed) >> 11) * (1.0 / 9007199254740992.0);
+  }
+}
+
+#endif
@@ -0,0 +1,119 @@
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/InputSourceMacros.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Sources/interface/ProducerSourceBase.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+#include "boost/shared_ptr.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace edm {
+  class EventIDListSource : public ProducerSourceBase {
+  public:
+    explicit EventIDListSource(ParameterSet const&, InputSourceDescription const&);
+    ~EventIDListSource();
+    static void fillDescriptions(ConfigurationDescriptions& descriptions);
+  private:
+    struct Entry {
+      Entry(EventID const& id, TimeValue_t time, bool hasTime) : id_(id), time_(time), hasTime_(hasTime) {}
+      EventID id_;
+      TimeValue_t time_;
+      bool hasTime_;
+    };
+
+    virtual bool setRunAndEventInfo(EventID& id, TimeValue_t& time);
+    virtual void produce(Event &);
+    //the next entry only depends on next_ so the skips done by ProducerSourceBase for
+    // 'skipEvents' and for the children of a multiprocess job would be ignored
+    virtual void postForkReacquireResources(boost::shared_ptr<multicore::MessageReceiverForSource>) override;
+
+    std::vector<Entry> entries_;
+    unsigned int next_;
+  };
+
+  EventIDListSource::EventIDListSource(ParameterSet const& pset,
+                                       InputSourceDescription const& desc) :
+    ProducerSourceBase(pset, desc, false),
+    entries_(),
+    next_(0) {
+    if(pset.existsAs<unsigned int>("skipEvents", false) && 0 != pset.getUntrackedParameter<unsigned int>("skipEvents")) {
+      throw edm::Exception(errors::Configuration) << "EventIDListSource: 'skipEvents' is not supported, remove the skipped events from the list instead.\n";
+    }
+    std::string const fileName = pset.getUntrackedParameter<std::string>("fileName");
+    std::ifstream file(fileName.c_str());
+    if(!file) {
+      throw edm::Exception(errors::Configuration) << "EventIDListSource: unable to open file \"" << fileName << "\".\n";
+    }
+    std::string line;
+    unsigned int lineNumber = 0;
+    while(std::getline(file, line)) {
+      ++lineNumber;
+      std::string::size_type const comment = line.find('#');
+      if(comment != std::string::npos) {
+        line.erase(comment);
+      }
+      std::istringstream fields(line);
+      RunNumber_t run = 0;
+      LuminosityBlockNumber_t lumi = 0;
+      EventNumber_t event = 0;
+      if(!(fields >> run)) {
+        //blank line
+        continue;
+      }
+      if(!(fields >> lumi >> event) || 0 == run || 0 == lumi || 0 == event) {
+        throw edm::Exception(errors::Configuration) << "EventIDListSource: line " << lineNumber << " of \"" << fileName
+          << "\" must hold non zero run, luminosity block and event numbers, optionally followed by a time.\n";
+      }
+      TimeValue_t time = 0;
+      bool const hasTime = static_cast<bool>(fields >> time);
+      entries_.push_back(Entry(EventID(run, lumi, event), time, hasTime));
+    }
+  }
+
+  EventIDListSource::~EventIDListSource() {
+  }
+
+  bool
+  EventIDListSource::setRunAndEventInfo(EventID& id, TimeValue_t& time) {
+    if(next_ == entries_.size()) {
+      return false;
+    }
+    Entry const& entry = entries_[next_];
+    ++next_;
+    id = entry.id_;
+    if(entry.hasTime_) {
+      time = entry.time_;
+    }
+    return true;
+  }
+
+  void
+  EventIDListSource::produce(edm::Event&) {
+  }
+
+  void
+  EventIDListSource::postForkReacquireResources(boost::shared_ptr<multicore::MessageReceiverForSource>) {
+    throw edm::Exception(errors::Configuration) << "EventIDListSource can not be used in a multiprocess job since each child would replay the whole list.\n";
+  }
+
+  void
+  EventIDListSource::fillDescriptions(ConfigurationDescriptions& descriptions) {
+    ParameterSetDescription desc;
+    desc.setComment("Creates runs, lumis and events containing no products, following exactly the list of EventIDs read from a text file.");
+    desc.addUntracked<std::string>("fileName")->setComment("Text file with one event per line: run, luminosity block and event numbers and optionally the time, "
+                                                          "separated by white space. Everything after a '#' is ignored. Events without a time get the time "
+                                                          "the source would have given them from 'firstTime' and 'timeBetweenEvents'.");
+    ProducerSourceBase::fillDescription(desc);
+    descriptions.add("eventIDListSource", desc);
+  }
+}
+
+using edm::EventIDListSource;
+DEFINE_FWK_INPUT_SOURCE(EventIDListSource);
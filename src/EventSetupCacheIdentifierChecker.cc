@@ -8,7 +8,11 @@
  Description: [one line class summary]
 
  Implementation:
-     [Notes on implementation]
+     The file written with 'recordToFile' and read with 'checkAgainstFile' holds, as native 32 bit
+     integers, a magic number, the number of records and the number of transitions, then for each
+     record the length of its name followed by the name padded with '\0' to a multiple of 4 bytes,
+     then for each record in the same order one cacheIdentifier per transition. 0 means the record
+     was not available. The file is memory mapped and the values are used in place.
 */
 //
 // Original Author:  Chris Jones
@@ -19,8 +23,11 @@
 
 
 // system include files
+#include <fstream>
+#include <limits>
 #include <memory>
 #include <map>
+#include <string>
 #include <vector>
 
 // user include files
@@ -37,6 +44,10 @@
 #include "FWCore/Utilities/interface/Exception.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "MappedFile.h"
+
 //
 // class declaration
 //
@@ -53,7 +64,7 @@ namespace edm {
    private:
     //virtual void beginJob() ;
     virtual void analyze(const edm::Event&, const edm::EventSetup&);
-    //virtual void endJob() ;
+    virtual void endJob() ;
 
     virtual void beginRun(edm::Run const&, edm::EventSetup const&);
     //virtual void endRun(edm::Run const&, edm::EventSetup const&);
@@ -62,10 +73,32 @@ namespace edm {
 
     void check(edm::EventSetup const&);
     void initialize();
+    void readExpectedFromFile();
+    void record(edm::EventSetup const&);
+    void writeRecorded() const;
+
+    // the expected values for one record: either one value per transition, owned or pointing
+    // into m_file, or (value, repeat count) pairs walked alongside the transitions
+    struct Expected {
+      Expected() : m_owned(), m_values(0), m_size(0), m_fromFile(false), m_runLengthEncoded(false), m_run(0), m_usedInRun(0) {}
+      bool next(unsigned int iIndex, unsigned int& oValue);
+      std::vector<unsigned int> m_owned;
+      unsigned int const* m_values;
+      unsigned int m_size;
+      bool m_fromFile; // then 0 means the record was not available
+      bool m_runLengthEncoded; // then m_owned holds the pairs
+      unsigned int m_run;
+      unsigned int m_usedInRun;
+    };
       // ----------member data ---------------------------
     ParameterSet m_pset;
-    std::map<eventsetup::EventSetupRecordKey,std::vector<unsigned int> > m_recordKeysToExpectedCacheIdentifiers;
+    std::map<eventsetup::EventSetupRecordKey,Expected> m_recordKeysToExpectedCacheIdentifiers;
     unsigned int m_index;
+    bool m_initialized;
+    std::string m_recordToFile;
+    std::string m_checkAgainstFile;
+    std::unique_ptr<MappedFile> m_file;
+    std::map<std::string,std::vector<unsigned int> > m_recorded;
   };
 }
 //
@@ -73,6 +106,8 @@ namespace edm {
 //
 using namespace edm;
 
+static unsigned int const kCacheIdentifierFileMagic = 0x45534349; // "ESCI"
+
 //
 // static data member definitions
 //
@@ -82,7 +117,10 @@ using namespace edm;
 //
 EventSetupCacheIdentifierChecker::EventSetupCacheIdentifierChecker(const edm::ParameterSet& iConfig):
 m_pset(iConfig),
-m_index(0)
+m_index(0),
+m_initialized(false),
+m_recordToFile(iConfig.getUntrackedParameter<std::string>("recordToFile", std::string())),
+m_checkAgainstFile(iConfig.getUntrackedParameter<std::string>("checkAgainstFile", std::string()))
 {
    //now do what ever initialization is needed
 
@@ -117,10 +155,13 @@ EventSetupCacheIdentifierChecker::analyze(const edm::Event& iEvent, const edm::E
 //}
 
 // ------------ method called once each job just after ending the event loop  ------------
-//void 
-//EventSetupCacheIdentifierChecker::endJob() 
-//{
-//}
+void 
+EventSetupCacheIdentifierChecker::endJob() 
+{
+  if(!m_recordToFile.empty()) {
+    writeRecorded();
+  }
+}
 
 // ------------ method called when starting to processes a run  ------------
 void 
@@ -151,11 +192,15 @@ EventSetupCacheIdentifierChecker::beginLuminosityBlock(edm::LuminosityBlock cons
 void
 EventSetupCacheIdentifierChecker::check(edm::EventSetup const& iSetup)
 {
-  if(0==m_recordKeysToExpectedCacheIdentifiers.size()) {
+  if(!m_initialized) {
     initialize();
   }
   using namespace edm::eventsetup;
 
+  if(!m_recordToFile.empty()) {
+    record(iSetup);
+  }
+
   
   for(auto it = m_recordKeysToExpectedCacheIdentifiers.begin(), itEnd = m_recordKeysToExpectedCacheIdentifiers.end();
       it != itEnd;
@@ -164,19 +209,48 @@ EventSetupCacheIdentifierChecker::check(edm::EventSetup const& iSetup)
     if(0 == pRecord) {
       edm::LogWarning("RecordNotInIOV") <<"The EventSetup Record '"<<it->first.name()<<"' is not available for this IOV.";
     }
-    if(it->second.size() <= m_index) {
+    unsigned int expected = 0;
+    if(!it->second.next(m_index, expected)) {
       throw cms::Exception("TooFewCacheIDs")<<"The vector of cacheIdentifiers for the record "<<it->first.name()<<" is too short";
     }
-    if(0 != pRecord && pRecord->cacheIdentifier() != it->second[m_index]) {
-      throw cms::Exception("IncorrectCacheID")<<"The Record "<<it->first.name()<<" was supposed to have cacheIdentifier: "<<it->second[m_index]<<" but instead has "<<pRecord->cacheIdentifier();
+    //a value of 0 read from a file means the record was not available when it was recorded
+    if(0 != pRecord && (!it->second.m_fromFile || 0 != expected) && pRecord->cacheIdentifier() != expected) {
+      throw cms::Exception("IncorrectCacheID")<<"The Record "<<it->first.name()<<" was supposed to have cacheIdentifier: "<<expected<<" but instead has "<<pRecord->cacheIdentifier();
     }
   }
   ++m_index;
 }
 
+bool
+EventSetupCacheIdentifierChecker::Expected::next(unsigned int iIndex, unsigned int& oValue)
+{
+  if(!m_runLengthEncoded) {
+    if(m_size <= iIndex) {
+      return false;
+    }
+    oValue = m_values[iIndex];
+    return true;
+  }
+  //transitions are checked in order so only the current pair needs to be looked at
+  while(2*m_run < m_owned.size() && m_usedInRun >= m_owned[2*m_run+1]) {
+    ++m_run;
+    m_usedInRun = 0;
+  }
+  if(2*m_run >= m_owned.size()) {
+    return false;
+  }
+  oValue = m_owned[2*m_run];
+  ++m_usedInRun;
+  return true;
+}
+
 void
 EventSetupCacheIdentifierChecker::initialize()
 {
+  m_initialized = true;
+  if(!m_checkAgainstFile.empty()) {
+    readExpectedFromFile();
+  }
   std::vector<std::string> recordNames{m_pset.getParameterNamesForType<std::vector<unsigned int> >(false)};
 
   for(auto const& name: recordNames) {
@@ -188,7 +262,124 @@ EventSetupCacheIdentifierChecker::initialize()
       continue;
     }
     
-    m_recordKeysToExpectedCacheIdentifiers.insert(std::make_pair(recordKey, m_pset.getUntrackedParameter<std::vector<unsigned int> >(name)));
+    //values given in the configuration take precedence over those from the file
+    Expected& expected = m_recordKeysToExpectedCacheIdentifiers[recordKey];
+    expected.m_owned = m_pset.getUntrackedParameter<std::vector<unsigned int> >(name);
+    expected.m_values = expected.m_owned.empty() ? 0 : &expected.m_owned[0];
+    expected.m_size = expected.m_owned.size();
+    expected.m_fromFile = false;
+  }
+
+  //by value, the default is a temporary
+  ParameterSet const encoded = m_pset.getUntrackedParameterSet("runLengthEncoded", ParameterSet());
+  std::vector<std::string> encodedRecordNames{encoded.getParameterNamesForType<std::vector<unsigned int> >(false)};
+  for(auto const& name: encodedRecordNames) {
+    eventsetup::EventSetupRecordKey recordKey(eventsetup::EventSetupRecordKey::TypeTag::findType(name));
+    if(recordKey.type() == eventsetup::EventSetupRecordKey::TypeTag()) {
+      //record not found
+      edm::LogWarning("DataGetter") <<"Record \""<< name <<"\" does not exist "<<std::endl;
+      
+      continue;
+    }
+    if(m_pset.existsAs<std::vector<unsigned int> >(name, false)) {
+      throw cms::Exception("Configuration")<<"The Record "<<name<<" has both explicit and run length encoded cacheIdentifiers";
+    }
+    Expected& expected = m_recordKeysToExpectedCacheIdentifiers[recordKey];
+    expected.m_owned = encoded.getUntrackedParameter<std::vector<unsigned int> >(name);
+    if(expected.m_owned.size() % 2 != 0) {
+      throw cms::Exception("Configuration")<<"The run length encoded cacheIdentifiers for the Record "<<name<<" must be (value, repeat count) pairs";
+    }
+    expected.m_fromFile = false;
+    expected.m_runLengthEncoded = true;
+  }
+}
+
+void
+EventSetupCacheIdentifierChecker::readExpectedFromFile()
+{
+  m_file.reset(new MappedFile(m_checkAgainstFile));
+  unsigned int const* begin = reinterpret_cast<unsigned int const*>(m_file->begin());
+  unsigned int const* end = begin + m_file->size()/sizeof(unsigned int);
+  if(end - begin < 3 || begin[0] != kCacheIdentifierFileMagic) {
+    throw cms::Exception("BadCacheIDFile")<<"The file "<<m_checkAgainstFile<<" does not hold recorded cacheIdentifiers";
+  }
+  unsigned int const nRecords = begin[1];
+  unsigned int const nTransitions = begin[2];
+  unsigned int const* current = begin + 3;
+
+  std::vector<std::string> names;
+  for(unsigned int i = 0; i != nRecords; ++i) {
+    //in 64 bits so a corrupt length close to the 32 bit limit can not wrap around
+    if(current == end || static_cast<unsigned long long>(end - current - 1) < (static_cast<unsigned long long>(*current) + 3)/4) {
+      throw cms::Exception("BadCacheIDFile")<<"The file "<<m_checkAgainstFile<<" is truncated";
+    }
+    unsigned int const length = *current;
+    ++current;
+    names.push_back(std::string(reinterpret_cast<char const*>(current), length));
+    current += (length + 3)/4;
+  }
+  if(static_cast<unsigned long long>(end - current) < static_cast<unsigned long long>(nRecords)*nTransitions) {
+    throw cms::Exception("BadCacheIDFile")<<"The file "<<m_checkAgainstFile<<" is truncated";
+  }
+  for(auto const& name: names) {
+    eventsetup::EventSetupRecordKey recordKey(eventsetup::EventSetupRecordKey::TypeTag::findType(name));
+    if(recordKey.type() == eventsetup::EventSetupRecordKey::TypeTag()) {
+      //record not found
+      edm::LogWarning("DataGetter") <<"Record \""<< name <<"\" does not exist "<<std::endl;
+    } else {
+      Expected& expected = m_recordKeysToExpectedCacheIdentifiers[recordKey];
+      expected.m_values = current;
+      expected.m_size = nTransitions;
+      expected.m_fromFile = true;
+    }
+    current += nTransitions;
+  }
+}
+
+void
+EventSetupCacheIdentifierChecker::record(edm::EventSetup const& iSetup)
+{
+  std::vector<eventsetup::EventSetupRecordKey> recordKeys;
+  iSetup.fillAvailableRecordKeys(recordKeys);
+  for(auto const& key: recordKeys) {
+    eventsetup::EventSetupRecord const* pRecord = iSetup.find(key);
+    if(0 == pRecord) {
+      continue;
+    }
+    std::vector<unsigned int>& ids = m_recorded[key.name()];
+    //records which were not available for earlier transitions get 0 for those
+    ids.resize(m_index, 0);
+    //the file holds 32 bit values
+    if(pRecord->cacheIdentifier() > std::numeric_limits<unsigned int>::max()) {
+      throw cms::Exception("BadCacheIDFile")<<"The cacheIdentifier "<<pRecord->cacheIdentifier()<<" of the Record "<<key.name()
+                                            <<" does not fit in the 32 bit values of the file "<<m_recordToFile;
+    }
+    ids.push_back(static_cast<unsigned int>(pRecord->cacheIdentifier()));
+  }
+}
+
+void
+EventSetupCacheIdentifierChecker::writeRecorded() const
+{
+  std::ofstream file(m_recordToFile.c_str(), std::ios::binary);
+  if(!file) {
+    throw cms::Exception("BadCacheIDFile")<<"Unable to open the file "<<m_recordToFile<<" for writing";
+  }
+  unsigned int const header[3] = {kCacheIdentifierFileMagic, static_cast<unsigned int>(m_recorded.size()), m_index};
+  file.write(reinterpret_cast<char const*>(header), sizeof(header));
+  for(auto const& recorded: m_recorded) {
+    unsigned int const length = recorded.first.size();
+    std::string padded(recorded.first);
+    padded.resize((length + 3)/4*4, '\0');
+    file.write(reinterpret_cast<char const*>(&length), sizeof(length));
+    file.write(padded.data(), padded.size());
+  }
+  for(auto const& recorded: m_recorded) {
+    std::vector<unsigned int> ids(recorded.second);
+    ids.resize(m_index, 0);
+    if(!ids.empty()) {
+      file.write(reinterpret_cast<char const*>(&ids[0]), ids.size()*sizeof(unsigned int));
+    }
   }
 }
 
@@ -199,6 +390,11 @@ EventSetupCacheIdentifierChecker::fillDescriptions(edm::ConfigurationDescription
   // Please change this to state exactly what you do use, even if it is no parameters
   edm::ParameterSetDescription desc;
   desc.addWildcardUntracked<std::vector<unsigned int> >("*")->setComment("The label is the name of an EventSetup Record while the vector contains the expected cacheIdentifier values for each beginRun, beginLuminosityBlock and event transition");
+  edm::ParameterSetDescription encoded;
+  encoded.addWildcardUntracked<std::vector<unsigned int> >("*")->setComment("The label is the name of an EventSetup Record while the vector holds (cacheIdentifier, number of transitions) pairs");
+  desc.addOptionalUntracked<edm::ParameterSetDescription>("runLengthEncoded", encoded)->setComment("Same as the top level Record parameters but run length encoded, which keeps configurations for long jobs small");
+  desc.addOptionalUntracked<std::string>("recordToFile")->setComment("Write the cacheIdentifiers of all available Records at each transition to this file at the end of the job.");
+  desc.addOptionalUntracked<std::string>("checkAgainstFile")->setComment("Check the cacheIdentifiers of the Records against those in this file, written by a previous job with 'recordToFile'.");
   descriptions.addDefault(desc);
 }
 
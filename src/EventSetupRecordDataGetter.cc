@@ -8,7 +8,13 @@
  Description: Can be configured to 'get' any Data in any EventSetup Record.  Primarily used for testing.
 
  Implementation:
-     <Notes on implementation>
+     The data of a Record are gotten again each time its cacheIdentifier changes. The EventSetup
+     only moves to new IOVs at beginRun and beginLuminosityBlock, so the records are only looked
+     up there and kept; an event just compares their cacheIdentifiers with the ones seen. The gets are
+     done one after the other: the EventSetup system calls the ESProducers and fills its caches
+     on the calling thread without any locking, so they must not be issued concurrently.
+     Since beginRun and beginLuminosityBlock also call doGet, the cost of building the data is
+     paid at those transitions rather than in the first event which needs them.
 */
 //
 // Original Author:  Chris Jones
@@ -18,13 +24,19 @@
 
 
 // system include files
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iomanip>
 #include <map>
 #include <vector>
 #include <memory>
 #include <set>
 #include <iostream>
+#include <unistd.h>
 
 // user include files
+#include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
@@ -33,11 +45,29 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/Run.h"
+#include "FWCore/Utilities/interface/CPUTimer.h"
 
 //
 // class decleration
 //
 namespace edm {
+   namespace {
+      //resident set size of the process in bytes, 0 if it can not be determined
+      long long residentMemory() {
+         long long pages = 0;
+         std::FILE* statm = std::fopen("/proc/self/statm", "r");
+         if(0 != statm) {
+            long long size = 0;
+            if(2 != std::fscanf(statm, "%lld %lld", &size, &pages)) {
+               pages = 0;
+            }
+            std::fclose(statm);
+         }
+         return pages * sysconf(_SC_PAGESIZE);
+      }
+   }
+
    class EventSetupRecordDataGetter : public EDAnalyzer {
 public:
      explicit EventSetupRecordDataGetter(ParameterSet const&);
@@ -47,18 +77,45 @@ public:
      virtual void analyze(Event const&, EventSetup const&);
      virtual void beginRun(Run const&, EventSetup const&);
      virtual void beginLuminosityBlock(LuminosityBlock const&, EventSetup const&);
+     virtual void endJob();
 
      static void fillDescriptions(ConfigurationDescriptions& descriptions);
 
 private:
-     void doGet(EventSetup const&);
+     void doGet(EventSetup const&, bool iFindRecords);
         // ----------member data ---------------------------
+     void addRecord(eventsetup::EventSetupRecordKey const&, std::vector<eventsetup::DataKey> const&, bool iMerge);
+
      ParameterSet pSet_;
-      
-     typedef std::map<eventsetup::EventSetupRecordKey, std::vector<eventsetup::DataKey> > RecordToDataKeys;
-     RecordToDataKeys recordToDataKeys_;
-     std::map<eventsetup::EventSetupRecordKey, unsigned long long> recordToCacheIdentifier_;
+
+     //cost of getting one data item, filled when 'profile' is set
+     struct LoadStats {
+        LoadStats() : loads_(0), totalTime_(0.), maxTime_(0.), memoryDelta_(0), provider_() {}
+        unsigned int loads_;
+        double totalTime_;
+        double maxTime_;
+        long long memoryDelta_;
+        std::string provider_;
+     };
+
+     //everything needed for one record, kept contiguous so the per transition check is a simple scan
+     struct RecordInfo {
+        RecordInfo(eventsetup::EventSetupRecordKey const& iKey, std::vector<eventsetup::DataKey> const& iDataKeys) :
+          key_(iKey), record_(0), dataKeys_(iDataKeys), cacheIdentifier_(0), stats_(iDataKeys.size()) {}
+        eventsetup::EventSetupRecordKey key_;
+        eventsetup::EventSetupRecord const* record_; //found at the last run or luminosity block transition, 0 if not in this IOV
+        std::vector<eventsetup::DataKey> dataKeys_;
+        unsigned long long cacheIdentifier_;
+        std::vector<LoadStats> stats_; //same order as dataKeys_
+     };
+
+     bool profiledGet(eventsetup::EventSetupRecord const&, RecordInfo&, unsigned int iIndex) const;
+
+     std::vector<RecordInfo> records_;
      bool verbose_;
+     bool profile_;
+     bool warmUp_;
+     double warmUpTime_;
 
   };
 
@@ -67,9 +124,11 @@ private:
 //
    EventSetupRecordDataGetter::EventSetupRecordDataGetter(ParameterSet const& iConfig) :
     pSet_(iConfig),
-    recordToDataKeys_(),
-    recordToCacheIdentifier_(),
-    verbose_(iConfig.getUntrackedParameter<bool>("verbose")) {}
+    records_(),
+    verbose_(iConfig.getUntrackedParameter<bool>("verbose")),
+    profile_(iConfig.getUntrackedParameter<bool>("profile")),
+    warmUp_(iConfig.getUntrackedParameter<bool>("warmUp")),
+    warmUpTime_(0.) {}
 
    EventSetupRecordDataGetter::~EventSetupRecordDataGetter() {
 
@@ -89,6 +148,11 @@ private:
       
       ParameterSetDescription desc;
       desc.addUntracked<bool>("verbose", false)->setComment("Print a message to the logger each time a data item is gotten.");
+      desc.addUntracked<bool>("profile", false)->setComment("Measure the wall time and the change of resident memory of each get and, at the end of the job, "
+                                                            "print for each data item the number of loads, total and maximum time, memory change and provider, "
+                                                            "most expensive first.");
+      desc.addUntracked<bool>("warmUp", false)->setComment("At each beginRun get all data registered in the EventSetup, in addition to 'toGet', and report "
+                                                           "how long it took. Nothing is gotten at beginLuminosityBlock or for events.");
 
       ParameterSetDescription toGet;
       toGet.add<std::string>("record")->setComment("The name of an EventSetup record holding the data you want obtained.");
@@ -113,23 +177,58 @@ private:
    }
 
    void 
-   EventSetupRecordDataGetter::beginRun(Run const&, EventSetup const& iSetup) {
-      doGet(iSetup);
+   EventSetupRecordDataGetter::beginRun(Run const& iRun, EventSetup const& iSetup) {
+      if(warmUp_) {
+         CPUTimer timer;
+         timer.start();
+         doGet(iSetup, true);
+         timer.stop();
+         double const time = timer.realTime();
+         warmUpTime_ += time;
+         edm::LogSystem("DataGetter") << "EventSetup warm-up for run " << iRun.run() << " took " << time << " s";
+         return;
+      }
+      doGet(iSetup, true);
    }
 
    void 
    EventSetupRecordDataGetter::beginLuminosityBlock(LuminosityBlock const&, EventSetup const& iSetup) {
-      doGet(iSetup);
+      if(warmUp_) {
+         return;
+      }
+      doGet(iSetup, true);
    }
    
    void
    EventSetupRecordDataGetter::analyze(edm::Event const& /*iEvent*/, edm::EventSetup const& iSetup) {
-      doGet(iSetup);
+      if(warmUp_) {
+         return;
+      }
+      doGet(iSetup, false);
    }
    
    void
-   EventSetupRecordDataGetter::doGet(EventSetup const& iSetup) {  
-      if(0 == recordToDataKeys_.size()) {
+   EventSetupRecordDataGetter::addRecord(eventsetup::EventSetupRecordKey const& iKey, std::vector<eventsetup::DataKey> const& iDataKeys, bool iMerge) {
+      //as for a map, the first entry for a record wins unless the keys are to be merged into it
+      for(std::vector<RecordInfo>::iterator it = records_.begin(), itEnd = records_.end(); it != itEnd; ++it) {
+         if(it->key_ == iKey) {
+            if(iMerge) {
+               for(std::vector<eventsetup::DataKey>::const_iterator itKey = iDataKeys.begin(), itKeyEnd = iDataKeys.end(); itKey != itKeyEnd; ++itKey) {
+                  if(std::find(it->dataKeys_.begin(), it->dataKeys_.end(), *itKey) == it->dataKeys_.end()) {
+                     it->dataKeys_.push_back(*itKey);
+                  }
+               }
+               it->stats_.resize(it->dataKeys_.size());
+            }
+            return;
+         }
+      }
+      records_.push_back(RecordInfo(iKey, iDataKeys));
+   }
+
+   void
+   EventSetupRecordDataGetter::doGet(EventSetup const& iSetup, bool iFindRecords) {  
+      if(records_.empty()) {
          typedef std::vector<ParameterSet> Parameters;
          Parameters const& toGet = pSet_.getParameterSetVector("toGet");
          
@@ -164,10 +263,9 @@ private:
                eventsetup::DataKey datumKey(datumType, labelName.c_str());
                dataKeys.push_back(datumKey); 
             }
-            recordToDataKeys_.insert(std::make_pair(recordKey, dataKeys));
-            recordToCacheIdentifier_.insert(std::make_pair(recordKey, 0));
+            addRecord(recordKey, dataKeys, false);
          }
-         if(toGet.empty()) {
+         if(toGet.empty() || warmUp_) {
             //This means we should get everything in the EventSetup
             std::vector<eventsetup::EventSetupRecordKey> recordKeys;
             iSetup.fillAvailableRecordKeys(recordKeys);
@@ -180,8 +278,8 @@ private:
                assert(record != 0);
                dataKeys.clear();
                record->fillRegisteredDataKeys(dataKeys);
-               recordToDataKeys_.insert(std::make_pair(*itRKey, dataKeys));
-               recordToCacheIdentifier_.insert(std::make_pair(*itRKey, 0));               
+               //when warming up, a record named in 'toGet' must still get all its data
+               addRecord(*itRKey, dataKeys, warmUp_);
             }
          }
       }
@@ -190,31 +288,100 @@ private:
 
       //For each requested Record get the requested data only if the Record is in a new IOV
       
-      for(RecordToDataKeys::iterator itRecord = recordToDataKeys_.begin(), itRecordEnd = recordToDataKeys_.end();
+      //Which records are valid depends on the IOV so they are looked up again at each run and luminosity block
+      if(iFindRecords) {
+         for(std::vector<RecordInfo>::iterator itRecord = records_.begin(), itRecordEnd = records_.end();
+              itRecord != itRecordEnd;
+              ++itRecord) {
+            itRecord->record_ = iSetup.find(itRecord->key_);
+            if(0 == itRecord->record_) {
+              edm::LogWarning("RecordNotInIOV") <<"The EventSetup Record '"<<itRecord->key_.name()<<"' is not available for this IOV.";
+            }
+         }
+      }
+      for(std::vector<RecordInfo>::iterator itRecord = records_.begin(), itRecordEnd = records_.end();
            itRecord != itRecordEnd;
            ++itRecord) {
-         EventSetupRecord const* pRecord = iSetup.find(itRecord->first);
-         if(0 == pRecord) {
-           edm::LogWarning("RecordNotInIOV") <<"The EventSetup Record '"<<itRecord->first.name()<<"' is not available for this IOV.";
-         }
-         if(0 != pRecord && pRecord->cacheIdentifier() != recordToCacheIdentifier_[itRecord->first]) {
-            recordToCacheIdentifier_[itRecord->first] = pRecord->cacheIdentifier();
+         EventSetupRecord const* pRecord = itRecord->record_;
+         if(0 != pRecord && pRecord->cacheIdentifier() != itRecord->cacheIdentifier_) {
+            itRecord->cacheIdentifier_ = pRecord->cacheIdentifier();
             typedef std::vector<DataKey> Keys;
-            Keys const& keys = itRecord->second;
+            Keys const& keys = itRecord->dataKeys_;
+            //must stay serial, see the notes on implementation above
             for(Keys::const_iterator itKey = keys.begin(), itKeyEnd = keys.end();
                  itKey != itKeyEnd;
                  ++itKey) {
-               if(! pRecord->doGet(*itKey)) {
-                 edm::LogWarning("DataGetter") << "No data of type \""<<itKey->type().name() <<"\" with name \""<< itKey->name().value()<<"\" in record "<<itRecord->first.type().name() <<" found "<< std::endl;
+               bool const found = profile_ ? profiledGet(*pRecord, *itRecord, itKey - keys.begin()) : pRecord->doGet(*itKey);
+               if(! found) {
+                 edm::LogWarning("DataGetter") << "No data of type \""<<itKey->type().name() <<"\" with name \""<< itKey->name().value()<<"\" in record "<<itRecord->key_.type().name() <<" found "<< std::endl;
                } else {
                   if(verbose_) {
-                    edm::LogSystem("DataGetter") << "got data of type \""<<itKey->type().name() <<"\" with name \""<< itKey->name().value()<<"\" in record "<<itRecord->first.type().name() << std::endl;
+                    edm::LogSystem("DataGetter") << "got data of type \""<<itKey->type().name() <<"\" with name \""<< itKey->name().value()<<"\" in record "<<itRecord->key_.type().name() << std::endl;
                   }
                }
             }
          }
       }
    }
+
+   bool
+   EventSetupRecordDataGetter::profiledGet(eventsetup::EventSetupRecord const& iRecord, RecordInfo& iInfo, unsigned int iIndex) const {
+      eventsetup::DataKey const& key = iInfo.dataKeys_[iIndex];
+      LoadStats& stats = iInfo.stats_[iIndex];
+
+      long long const memoryBefore = residentMemory();
+      CPUTimer timer;
+      timer.start();
+      bool const found = iRecord.doGet(key);
+      timer.stop();
+      double const time = timer.realTime();
+      long long const memoryAfter = residentMemory();
+
+      ++stats.loads_;
+      stats.totalTime_ += time;
+      stats.maxTime_ = std::max(stats.maxTime_, time);
+      stats.memoryDelta_ += memoryAfter - memoryBefore;
+      if(stats.provider_.empty()) {
+         eventsetup::ComponentDescription const* cd = iRecord.providerDescription(key);
+         if(0 != cd) {
+            stats.provider_ = "'" + cd->label_ + "' " + cd->type_;
+         }
+      }
+      return found;
+   }
+
+   void
+   EventSetupRecordDataGetter::endJob() {
+      if(warmUp_) {
+         edm::LogSystem("DataGetter") << "Total EventSetup warm-up time " << warmUpTime_ << " s";
+      }
+      if(!profile_) {
+         return;
+      }
+      typedef std::pair<double, std::pair<unsigned int, unsigned int> > TimeToItem;
+      std::vector<TimeToItem> ranking;
+      for(unsigned int iRecord = 0; iRecord != records_.size(); ++iRecord) {
+         for(unsigned int iKey = 0; iKey != records_[iRecord].stats_.size(); ++iKey) {
+            if(0 != records_[iRecord].stats_[iKey].loads_) {
+               ranking.push_back(std::make_pair(records_[iRecord].stats_[iKey].totalTime_, std::make_pair(iRecord, iKey)));
+            }
+         }
+      }
+      std::sort(ranking.begin(), ranking.end(), std::greater<TimeToItem>());
+
+      LogSystem log("DataGetter");
+      log << "EventSetup data ranked by total time to get them\n"
+          << std::setw(8) << "loads" << std::setw(14) << "total [s]" << std::setw(14) << "max [s]" << std::setw(14) << "memory [kB]"
+          << "  record  <datatype> 'label'  provider: 'provider label' <provider module type>\n";
+      for(std::vector<TimeToItem>::const_iterator it = ranking.begin(), itEnd = ranking.end(); it != itEnd; ++it) {
+         RecordInfo const& info = records_[it->second.first];
+         eventsetup::DataKey const& key = info.dataKeys_[it->second.second];
+         LoadStats const& stats = info.stats_[it->second.second];
+         log << std::setw(8) << stats.loads_ << std::setw(14) << stats.totalTime_ << std::setw(14) << stats.maxTime_
+             << std::setw(14) << stats.memoryDelta_ / 1024
+             << "  " << info.key_.name() << "  " << key.type().name() << " '" << key.name().value() << "'  provider: " << stats.provider_ << "\n";
+      }
+   }
 }
 using edm::EventSetupRecordDataGetter;
 DEFINE_FWK_MODULE(EventSetupRecordDataGetter);
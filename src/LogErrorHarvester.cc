@@ -8,7 +8,11 @@
 
  Implementation:
      This simple implementation writes the std::vector<ErrorSummaryEntry> in the event,
-     without any fancy attempt of encoding the strings or mapping them to ints
+     without any fancy attempt of encoding the strings or mapping them to ints.
+     Optionally the entries are also summed per (category, module, severity) over
+     the luminosity block and written once into the LuminosityBlock at its end.
+     The per event product can be bounded in number of entries and bytes, in which
+     case the least severe entries are replaced by a single overflow entry.
 */
 //
 // Original Author:  Giovanni Petrucciani
@@ -16,36 +20,88 @@
 //
 
 // user include files
-#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/one/EDProducer.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/MessageLogger/interface/ErrorSummaryEntry.h"
 #include "FWCore/MessageLogger/interface/LoggedErrorsSummary.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 
 // system include files
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <vector>
 
 //
 // class decleration
 //
 
 namespace edm {
-  class LogErrorHarvester : public EDProducer {
+  namespace {
+    // orders entries by (category, module, severity), ignoring the count
+    struct ErrorSummaryEntryKindLess {
+      bool operator()(ErrorSummaryEntry const& iLHS, ErrorSummaryEntry const& iRHS) const {
+        if(iLHS.category != iRHS.category) return iLHS.category < iRHS.category;
+        if(iLHS.module != iRHS.module) return iLHS.module < iRHS.module;
+        return iLHS.severity.getLevel() < iRHS.severity.getLevel();
+      }
+    };
+
+    struct MoreSevere {
+      bool operator()(ErrorSummaryEntry const& iLHS, ErrorSummaryEntry const& iRHS) const {
+        return iLHS.severity.getLevel() > iRHS.severity.getLevel();
+      }
+    };
+
+    std::string const kOverflowCategory("LogErrorHarvesterOverflow");
+    std::string const kOverflowModule("LogErrorHarvester");
+
+    unsigned int entrySize(ErrorSummaryEntry const& iEntry) {
+      return sizeof(ErrorSummaryEntry) + iEntry.category.size() + iEntry.module.size();
+    }
+  }
+
+  //putting into the LuminosityBlock needs the end luminosity block produce transition
+  class LogErrorHarvester : public one::EDProducer<EndLuminosityBlockProducer> {
     public:
       explicit LogErrorHarvester(ParameterSet const&);
       ~LogErrorHarvester();
       static void fillDescriptions(ConfigurationDescriptions& descriptions);
 
     private:
-      virtual void beginJob();
-      virtual void produce(Event&, EventSetup const&);
-      virtual void endJob() ;
+      virtual void beginJob() override;
+      virtual void produce(Event&, EventSetup const&) override;
+      virtual void endJob() override;
+      virtual void endLuminosityBlockProduce(LuminosityBlock&, EventSetup const&) override;
+
+      void accumulate(std::vector<ErrorSummaryEntry> const&);
+      void truncate(std::vector<ErrorSummaryEntry>&) const;
+
+      typedef std::map<ErrorSummaryEntry, unsigned int, ErrorSummaryEntryKindLess> KindToCount;
+
+      bool perEvent_;
+      bool perLuminosityBlock_;
+      unsigned int maxEntriesPerEvent_;
+      unsigned int maxBytesPerEvent_;
+      KindToCount lumiCounts_;
   };
 
-  LogErrorHarvester::LogErrorHarvester(ParameterSet const&) {
-     produces<std::vector<ErrorSummaryEntry> >();
+  LogErrorHarvester::LogErrorHarvester(ParameterSet const& iPSet) :
+    perEvent_(iPSet.getParameter<bool>("perEvent")),
+    perLuminosityBlock_(iPSet.getParameter<bool>("perLuminosityBlock")),
+    maxEntriesPerEvent_(iPSet.getParameter<unsigned int>("maxEntriesPerEvent")),
+    maxBytesPerEvent_(iPSet.getParameter<unsigned int>("maxBytesPerEvent")),
+    lumiCounts_() {
+     if(perEvent_) {
+       produces<std::vector<ErrorSummaryEntry> >();
+     }
+     if(perLuminosityBlock_) {
+       produces<std::vector<ErrorSummaryEntry>, InLumi>();
+     }
   }
 
   LogErrorHarvester::~LogErrorHarvester() {
@@ -53,13 +109,84 @@ namespace edm {
 
   void
   LogErrorHarvester::produce(Event& iEvent, EventSetup const&) {
-    if(!FreshErrorsExist()) {
-      std::auto_ptr<std::vector<ErrorSummaryEntry> > errors(new std::vector<ErrorSummaryEntry>());
-      iEvent.put(errors);
-    } else {
-      std::auto_ptr<std::vector<ErrorSummaryEntry> > errors(new std::vector<ErrorSummaryEntry>(LoggedErrorsSummary()));
-      iEvent.put(errors);
+    if(!perEvent_) {
+      if(perLuminosityBlock_ && FreshErrorsExist()) {
+        accumulate(LoggedErrorsSummary());
+      }
+      return;
+    }
+    //The per event cost is set by Event::put, which takes ownership of a new vector even
+    // when nothing was logged, and by LoggedErrorsSummary, which returns its entries by value
+    std::auto_ptr<std::vector<ErrorSummaryEntry> > errors(FreshErrorsExist() ? new std::vector<ErrorSummaryEntry>(LoggedErrorsSummary())
+                                                                             : new std::vector<ErrorSummaryEntry>());
+    if(!errors->empty()) {
+      if(perLuminosityBlock_) {
+        accumulate(*errors);
+      }
+      truncate(*errors);
+    }
+    iEvent.put(errors);
+  }
+
+  void
+  LogErrorHarvester::accumulate(std::vector<ErrorSummaryEntry> const& iErrors) {
+    for(std::vector<ErrorSummaryEntry>::const_iterator it = iErrors.begin(), itEnd = iErrors.end();
+        it != itEnd;
+        ++it) {
+      lumiCounts_[*it] += it->count;
+    }
+  }
+
+  void
+  LogErrorHarvester::truncate(std::vector<ErrorSummaryEntry>& ioErrors) const {
+    if(0 == maxEntriesPerEvent_ && 0 == maxBytesPerEvent_) {
+      return;
+    }
+    //the overflow entry itself counts against the limits
+    unsigned int const overflowSize = sizeof(ErrorSummaryEntry) + kOverflowCategory.size() + kOverflowModule.size();
+    unsigned int const maxEntries = 0 == maxEntriesPerEvent_ ? ioErrors.size() : maxEntriesPerEvent_;
+
+    unsigned int totalBytes = 0;
+    for(std::vector<ErrorSummaryEntry>::const_iterator it = ioErrors.begin(), itEnd = ioErrors.end(); it != itEnd; ++it) {
+      totalBytes += entrySize(*it);
+    }
+    if(ioErrors.size() <= maxEntries && (0 == maxBytesPerEvent_ || totalBytes <= maxBytesPerEvent_)) {
+      return;
+    }
+
+    //keep the most severe entries
+    std::stable_sort(ioErrors.begin(), ioErrors.end(), MoreSevere());
+    unsigned int kept = 0;
+    unsigned int keptBytes = overflowSize;
+    while(kept < ioErrors.size() && kept + 1 < maxEntries &&
+          (0 == maxBytesPerEvent_ || keptBytes + entrySize(ioErrors[kept]) <= maxBytesPerEvent_)) {
+      keptBytes += entrySize(ioErrors[kept]);
+      ++kept;
+    }
+
+    ErrorSummaryEntry overflow(kOverflowCategory, kOverflowModule, ioErrors[kept].severity, 0);
+    for(std::vector<ErrorSummaryEntry>::const_iterator it = ioErrors.begin() + kept, itEnd = ioErrors.end(); it != itEnd; ++it) {
+      overflow.count += it->count;
+    }
+    ioErrors.resize(kept);
+    ioErrors.push_back(overflow);
+  }
+
+  void
+  LogErrorHarvester::endLuminosityBlockProduce(LuminosityBlock& iLumi, EventSetup const&) {
+    if(!perLuminosityBlock_) {
+      return;
+    }
+    std::auto_ptr<std::vector<ErrorSummaryEntry> > errors(new std::vector<ErrorSummaryEntry>());
+    errors->reserve(lumiCounts_.size());
+    for(KindToCount::const_iterator it = lumiCounts_.begin(), itEnd = lumiCounts_.end();
+        it != itEnd;
+        ++it) {
+      errors->push_back(it->first);
+      errors->back().count = it->second;
     }
+    lumiCounts_.clear();
+    iLumi.put(errors);
   }
 
   // ------------ method called once each job just before starting event loop  ------------
@@ -79,6 +206,10 @@ namespace edm {
   void
   LogErrorHarvester::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
+    desc.add<bool>("perEvent", true)->setComment("Put the errors and warnings logged since the previous event into each Event.");
+    desc.add<bool>("perLuminosityBlock", false)->setComment("Put the errors and warnings summed per (category, module, severity) over the whole luminosity block into the LuminosityBlock.");
+    desc.add<unsigned int>("maxEntriesPerEvent", 0)->setComment("Maximum number of entries put into each Event, including the '" + kOverflowCategory + "' entry which replaces the least severe ones. 0 means no limit.");
+    desc.add<unsigned int>("maxBytesPerEvent", 0)->setComment("Approximate maximum size in bytes of the entries put into each Event, including the overflow entry. 0 means no limit.");
     descriptions.add("logErrorHarvester", desc);
   }
 }
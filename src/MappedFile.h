@@ -0,0 +1,66 @@
+#ifndef FWCore_Modules_MappedFile_h
+#define FWCore_Modules_MappedFile_h
+// -*- C++ -*-
+//
+// Package:     Modules
+// Class  :     MappedFile
+//
+/**\class MappedFile MappedFile.h FWCore/Modules/src/MappedFile.h
+
+ Description: Read only memory mapping of a whole file
+
+ Usage:
+    The mapping is released when the object goes out of scope. An empty
+    file gives a size of 0 and a null begin().
+*/
+//
+
+// system include files
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// user include files
+#include "FWCore/Utilities/interface/EDMException.h"
+
+namespace edm {
+  class MappedFile {
+  public:
+    explicit MappedFile(std::string const& iName) : address_(MAP_FAILED), size_(0) {
+      int fd = open(iName.c_str(), O_RDONLY);
+      if(fd < 0) {
+        throw edm::Exception(errors::FileOpenError) << "Could not open the file \"" << iName << "\".";
+      }
+      struct stat info;
+      if(0 == fstat(fd, &info)) {
+        size_ = info.st_size;
+        if(size_ != 0) {
+          address_ = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+      }
+      close(fd);
+      if(size_ != 0 && address_ == MAP_FAILED) {
+        throw edm::Exception(errors::FileReadError) << "Could not map the file \"" << iName << "\" into memory.";
+      }
+    }
+    ~MappedFile() {
+      if(address_ != MAP_FAILED) {
+        munmap(address_, size_);
+      }
+    }
+
+    char const* begin() const { return size_ != 0 ? static_cast<char const*>(address_) : 0; }
+    size_t size() const { return size_; }
+
+  private:
+    MappedFile(MappedFile const&); // stop default
+    MappedFile const& operator=(MappedFile const&); // stop default
+
+    void* address_;
+    size_t size_;
+  };
+}
+
+#endif
@@ -1,11 +1,28 @@
 
 #include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "DataFormats/Provenance/interface/LuminosityBlockID.h"
+#include "EventIDHash.h"
+
+#include <algorithm>
+#include <vector>
 
 namespace edm {
+  namespace {
+    void checkPrescale(int n, int offset, char const* iWhere) {
+      if(n <= 0 || offset < 0 || offset >= n) {
+        throw edm::Exception(errors::Configuration) << "Prescaler: " << iWhere << " has 'prescaleFactor' " << n << " and 'prescaleOffset' " << offset
+          << " but 0 <= 'prescaleOffset' < 'prescaleFactor' is required.\n";
+      }
+    }
+  }
+
   class Prescaler : public EDFilter {
   public:
     explicit Prescaler(ParameterSet const&);
@@ -13,26 +30,73 @@ namespace edm {
 
     static void fillDescriptions(ConfigurationDescriptions& descriptions);
     virtual bool filter(Event& e, EventSetup const& c);
+    virtual void beginLuminosityBlock(LuminosityBlock const& lb, EventSetup const& c);
     void endJob();
 
   private:
+    struct PrescaleColumn {
+      PrescaleColumn(LuminosityBlockID const& first, int n, int offset) : first_(first), n_(n), offset_(offset) {}
+      bool operator<(PrescaleColumn const& other) const { return first_ < other.first_; }
+      LuminosityBlockID first_; // the column applies from this luminosity block until the next column starts
+      int n_;
+      int offset_;
+    };
+
     int count_;
     int n_; // accept one in n
     int offset_; // with offset, ie. sequence of events does not have to start at first event
+    bool useEventIDHash_; // decide from the EventID alone instead of counting
+    unsigned long long hashSeed_;
+    int defaultN_;
+    int defaultOffset_;
+    std::vector<PrescaleColumn> table_; // sorted by first luminosity block
   };
 
   Prescaler::Prescaler(ParameterSet const& ps) :
     count_(),
     n_(ps.getParameter<int>("prescaleFactor")),
-    offset_(ps.getParameter<int>("prescaleOffset")) {
+    offset_(ps.getParameter<int>("prescaleOffset")),
+    useEventIDHash_(ps.getParameter<bool>("useEventIDHash")),
+    hashSeed_(ps.getParameter<unsigned int>("hashSeed")),
+    defaultN_(n_),
+    defaultOffset_(offset_),
+    table_() {
+    checkPrescale(n_, offset_, "the module");
+    typedef std::vector<ParameterSet> Parameters;
+    Parameters const& table = ps.getParameterSetVector("prescaleTable");
+    for(Parameters::const_iterator it = table.begin(), itEnd = table.end(); it != itEnd; ++it) {
+      PrescaleColumn column(LuminosityBlockID(it->getParameter<unsigned int>("firstRun"), it->getParameter<unsigned int>("firstLuminosityBlock")),
+                            it->getParameter<int>("prescaleFactor"),
+                            it->getParameter<int>("prescaleOffset"));
+      checkPrescale(column.n_, column.offset_, "a 'prescaleTable' entry");
+      table_.push_back(column);
+    }
+    std::stable_sort(table_.begin(), table_.end());
   }
 
   Prescaler::~Prescaler() {
   }
 
-  bool Prescaler::filter(Event&, EventSetup const&) {
-    ++count_;
-    return count_ % n_ == offset_ ? true : false;
+  bool Prescaler::filter(Event& e, EventSetup const&) {
+    //both are in [0, n_) since 0 <= offset_ < n_ is checked at construction
+    int const position = useEventIDHash_ ? static_cast<int>(hashEventID(e.id(), hashSeed_) % n_) : ++count_ % n_;
+    return position == offset_;
+  }
+
+  void Prescaler::beginLuminosityBlock(LuminosityBlock const& lb, EventSetup const&) {
+    if(table_.empty()) {
+      return;
+    }
+    //the last column starting at or before this luminosity block
+    std::vector<PrescaleColumn>::const_iterator it = std::upper_bound(table_.begin(), table_.end(), PrescaleColumn(lb.id(), 0, 0));
+    if(it == table_.begin()) {
+      n_ = defaultN_;
+      offset_ = defaultOffset_;
+    } else {
+      --it;
+      n_ = it->n_;
+      offset_ = it->offset_;
+    }
   }
 
   void Prescaler::endJob() {
@@ -42,7 +106,20 @@ namespace edm {
   Prescaler::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
     desc.add<int>("prescaleFactor")->setComment("Accept one event every N events");
-    desc.add<int>("prescaleOffset")->setComment("The first event to accept should be the Mth one. Choose 'prescaleFactor'=1 to accept the first event from the source.");
+    desc.add<int>("prescaleOffset")->setComment("The first event to accept should be the Mth one. Choose 'prescaleFactor'=1 to accept the first event from the source. "
+                                               "Must be in [0, 'prescaleFactor').");
+    desc.add<bool>("useEventIDHash", false)->setComment("Instead of counting events, accept an event when a hash of its run, luminosity block and event numbers modulo 'prescaleFactor' equals 'prescaleOffset'. "
+                                                       "The selection is then reproducible whatever the number of processes or the processing order.");
+    desc.add<unsigned int>("hashSeed", 0)->setComment("Seed combined with the EventID when 'useEventIDHash' is true. Different seeds select different events.");
+
+    ParameterSetDescription column;
+    column.add<unsigned int>("firstRun")->setComment("Run of the first luminosity block this entry applies to.");
+    column.add<unsigned int>("firstLuminosityBlock", 0)->setComment("First luminosity block this entry applies to.");
+    column.add<int>("prescaleFactor")->setComment("Accept one event every N events.");
+    column.add<int>("prescaleOffset", 0)->setComment("Same meaning as the module level 'prescaleOffset'.");
+    desc.addVPSet("prescaleTable", column, std::vector<ParameterSet>())->setComment("Prescale schedule. Each entry applies from its first luminosity block until the next entry starts. "
+                                                                                    "The choice is made once per luminosity block. Luminosity blocks before the first entry use "
+                                                                                    "the module level 'prescaleFactor' and 'prescaleOffset'.");
     descriptions.add("preScaler", desc);
   }
 }
@@ -6,10 +6,21 @@
 //
 /**\class PrintEventSetupContent PrintEventSetupContent.cc GetRecordName/PrintEventSetupContent/src/PrintEventSetupContent.cc
 
- Description: <one line class summary>
+ Description: Prints the EventSetup records which changed at each transition.
 
  Implementation:
-     <Notes on implementation>
+     By default each record whose cacheIdentifier changed since it was last seen is printed to
+     the log with its IOV and, for each of its data items, the type, label and provider.
+     If 'timelineFile' is set, the changes are written to that file instead of the log, one
+     tab separated line per data item of each changed record:
+       transition run lumi event record
+       IOV start run lumi event time, IOV end run lumi event time, cacheIdentifier,
+       data type, data label, provider label, provider type
+     where transition is one of beginRun, beginLuminosityBlock or event.
+     The script edmEventSetupTimeline.py summarizes such a file.
+     The available records and the records found for them are only refreshed at beginRun and
+     beginLuminosityBlock, the only transitions at which the EventSetup moves to new IOVs, so
+     for an event only the cached cacheIdentifiers are compared.
 */
 //
 // Original Author:  Weng Yao
@@ -20,19 +31,28 @@
 // user include files
 #include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
 #include "FWCore/Framework/interface/IOVSyncValue.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Framework/interface/Run.h"
 #include "FWCore/Framework/interface/ValidityInterval.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDMException.h"
 
 // system include files
+#include <algorithm>
+#include <fstream>
 #include <iostream>
-#include <map>
 #include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
 
 //
 // class decleration
@@ -54,10 +74,22 @@ namespace edm {
       virtual void beginRun(Run const&, EventSetup const&);
       virtual void beginLuminosityBlock(LuminosityBlock const&, EventSetup const&);
 
-      void print(EventSetup const&);
+      void print(EventSetup const&, char const* iTransition, EventID const& iID, bool iRefresh);
+      void updateRecords();
+      void writeTimeline(eventsetup::EventSetupRecord const& iRecord, eventsetup::EventSetupRecordKey const& iKey,
+                         char const* iTransition, EventID const& iID);
 
       // ----------member data ---------------------------
-  std::map<eventsetup::EventSetupRecordKey, unsigned long long > cacheIdentifiers_;
+  //the records seen last time and, in the same order, the records found for them at the
+  //last run or luminosity block transition and their last printed cacheIdentifier
+  std::vector<eventsetup::EventSetupRecordKey> records_;
+  std::vector<eventsetup::EventSetupRecord const*> recordPointers_;
+  std::vector<unsigned long long> cacheIdentifiers_;
+  //refilled at each call, kept as a member to reuse its memory
+  std::vector<eventsetup::EventSetupRecordKey> available_;
+  std::vector<eventsetup::DataKey> data_;
+  //only open if a timeline was requested
+  std::ofstream timeline_;
 };
 
 //
@@ -71,7 +103,23 @@ namespace edm {
 //
 // constructors and destructor
 //
-  PrintEventSetupContent::PrintEventSetupContent(ParameterSet const&) {
+  PrintEventSetupContent::PrintEventSetupContent(ParameterSet const& iConfig) :
+    records_(),
+    recordPointers_(),
+    cacheIdentifiers_(),
+    available_(),
+    data_(),
+    timeline_() {
+    std::string const timelineFile = iConfig.getUntrackedParameter<std::string>("timelineFile");
+    if(!timelineFile.empty()) {
+      timeline_.open(timelineFile.c_str());
+      if(!timeline_) {
+        throw edm::Exception(errors::Configuration) << "PrintEventSetupContent: unable to open the timeline file \"" << timelineFile << "\".";
+      }
+      timeline_ << "#transition\trun\tlumi\tevent\trecord"
+                << "\tstartRun\tstartLumi\tstartEvent\tstartTime\tendRun\tendLumi\tendEvent\tendTime"
+                << "\tcacheIdentifier\tdataType\tdataLabel\tproviderLabel\tproviderType\n";
+    }
   //now do what ever initialization is neededEventSetupRecordDataGetter::EventSetupRecordDataGetter(ParameterSet const& iConfig):
   //  getter = new EventSetupRecordDataGetter::EventSetupRecordDataGetter(iConfig);
   }
@@ -87,47 +135,95 @@ namespace edm {
 
   // ------------ method called to for each event  ------------
   void
-  PrintEventSetupContent::analyze(Event const&, EventSetup const& iSetup) {
-    print(iSetup);
+  PrintEventSetupContent::analyze(Event const& iEvent, EventSetup const& iSetup) {
+    print(iSetup, "event", iEvent.id(), false);
   }
 
   void
-  PrintEventSetupContent::beginRun(Run const&, EventSetup const& iSetup){
-    print(iSetup);
+  PrintEventSetupContent::beginRun(Run const& iRun, EventSetup const& iSetup){
+    print(iSetup, "beginRun", EventID(iRun.run(), 0, 0), true);
   }
 
   void
-  PrintEventSetupContent::beginLuminosityBlock(LuminosityBlock const&, EventSetup const& iSetup){
-    print(iSetup);
+  PrintEventSetupContent::beginLuminosityBlock(LuminosityBlock const& iLumi, EventSetup const& iSetup){
+    print(iSetup, "beginLuminosityBlock", EventID(iLumi.run(), iLumi.luminosityBlock(), 0), true);
   }
 
   void
-  PrintEventSetupContent::print (EventSetup const& iSetup) {
+  PrintEventSetupContent::updateRecords() {
+    //keep the cacheIdentifiers of the records which were already known
+    std::vector<unsigned long long> cacheIdentifiers(available_.size(), 0);
+    for(unsigned int i = 0; i != available_.size(); ++i) {
+      std::vector<eventsetup::EventSetupRecordKey>::const_iterator itFound = std::find(records_.begin(), records_.end(), available_[i]);
+      if(itFound != records_.end()) {
+        cacheIdentifiers[i] = cacheIdentifiers_[itFound - records_.begin()];
+      }
+    }
+    records_ = available_;
+    recordPointers_.assign(records_.size(), 0);
+    cacheIdentifiers_.swap(cacheIdentifiers);
+  }
+
+  void
+  PrintEventSetupContent::writeTimeline(eventsetup::EventSetupRecord const& iRecord, eventsetup::EventSetupRecordKey const& iKey,
+                                        char const* iTransition, EventID const& iID) {
+    IOVSyncValue const& first = iRecord.validityInterval().first();
+    IOVSyncValue const& last = iRecord.validityInterval().last();
+    std::ostringstream prefix;
+    prefix << iTransition << "\t" << iID.run() << "\t" << iID.luminosityBlock() << "\t" << iID.event() << "\t" << iKey.name()
+           << "\t" << first.eventID().run() << "\t" << first.eventID().luminosityBlock() << "\t" << first.eventID().event() << "\t" << first.time().value()
+           << "\t" << last.eventID().run() << "\t" << last.eventID().luminosityBlock() << "\t" << last.eventID().event() << "\t" << last.time().value()
+           << "\t" << iRecord.cacheIdentifier();
+    if(data_.empty()) {
+      timeline_ << prefix.str() << "\t\t\t\t\n";
+      return;
+    }
+    for(std::vector<eventsetup::DataKey>::const_iterator itdata = data_.begin(), itdataend = data_.end(); itdata != itdataend; ++itdata) {
+      edm::eventsetup::ComponentDescription const* cd = iRecord.providerDescription(*itdata);
+      timeline_ << prefix.str() << "\t" << itdata->type().name() << "\t" << itdata->name().value()
+                << "\t" << cd->label_ << "\t" << cd->type_ << "\n";
+    }
+  }
+
+  void
+  PrintEventSetupContent::print (EventSetup const& iSetup, char const* iTransition, EventID const& iID, bool iRefresh) {
     typedef std::vector<eventsetup::EventSetupRecordKey> Records;
     typedef std::vector<eventsetup::DataKey> Data;
 
-    Records records;
-    Data data;
-    iSetup.fillAvailableRecordKeys(records);
+    //the EventSetup is only synchronized to a new IOV at run and luminosity block transitions
+    if(iRefresh) {
+      available_.clear();
+      iSetup.fillAvailableRecordKeys(available_);
+      if(available_ != records_) {
+        updateRecords();
+      }
+      for(unsigned int index = 0; index != records_.size(); ++index) {
+        recordPointers_[index] = iSetup.find(records_[index]);
+      }
+    }
     int iflag=0;
 
-    for(Records::iterator itrecords = records.begin(), itrecordsend = records.end();
-       itrecords != itrecordsend; ++itrecords ) {
+    for(unsigned int index = 0; index != records_.size(); ++index) {
+      Records::const_iterator itrecords = records_.begin() + index;
+      eventsetup::EventSetupRecord const* rec = recordPointers_[index];
 
-      eventsetup::EventSetupRecord const* rec = iSetup.find(*itrecords);
-
-      if(0 != rec && cacheIdentifiers_[*itrecords] != rec->cacheIdentifier() ) {
+      if(0 != rec && cacheIdentifiers_[index] != rec->cacheIdentifier() ) {
+        cacheIdentifiers_[index] = rec->cacheIdentifier();
+        if(timeline_.is_open()) {
+          rec->fillRegisteredDataKeys(data_);
+          writeTimeline(*rec, *itrecords, iTransition, iID);
+          continue;
+        }
         ++iflag;
         if(iflag==1) {
           LogSystem("ESContent") << "\n" << "Changed Record" << "\n  " << "<datatype>" << " " << "'label' provider: 'provider label' <provider module type>";
         }
-        cacheIdentifiers_[*itrecords] = rec->cacheIdentifier();
         LogAbsolute("ESContent") << itrecords->name() << std::endl;
 
         LogAbsolute("ESContent") << " start: " << rec->validityInterval().first().eventID() << " time: " << rec->validityInterval().first().time().value() << std::endl;
         LogAbsolute("ESContent") << " end:   " << rec->validityInterval().last().eventID() << " time: " << rec->validityInterval().last().time().value() << std::endl;
-        rec->fillRegisteredDataKeys(data);
-        for(Data::iterator itdata = data.begin(), itdataend = data.end(); itdata != itdataend; ++itdata){
+        rec->fillRegisteredDataKeys(data_);
+        for(Data::iterator itdata = data_.begin(), itdataend = data_.end(); itdata != itdataend; ++itdata){
           edm::eventsetup::ComponentDescription const* cd = rec->providerDescription(*itdata);
           LogAbsolute("ESContent") << "  " << itdata->type().name() << " '" << itdata->name().value() << "'" << " provider:'" << cd->label_ << "' " << cd->type_ << std::endl;
         }
@@ -159,6 +255,8 @@ namespace edm {
   void
   PrintEventSetupContent::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
+    desc.addUntracked<std::string>("timelineFile", std::string())
+      ->setComment("If not empty, the changed records are written as tab separated lines to this file instead of to the log.");
     descriptions.setComment("Print what data is available in each available EventSetup Record in the job.\n"
                             "As part of the data is the C++ class type, label and which module makes that data.");
     descriptions.add("printEventSetupContent", desc);
@@ -6,6 +6,16 @@
 // Implementation:
 //     Checks the consistency of provenance stored in the framework
 //
+//     The ancestors of a product are found by walking the parentage with an explicit stack.
+//     As before, a walk does not go past a BranchID already seen in the event, so each BranchID
+//     is asked from the BranchMapper at most once per event. The parents of a ParentageID never
+//     change, so they are kept across events instead of being looked up in the registry again.
+//
+//     Only a sample of the events can be checked, either every Nth event or the events whose
+//     EventID hash falls below 'sampleFraction'. The checks of one event stay serial since
+//     EventPrincipal::getForOutput fills the ProductHolders and is not safe to call from
+//     several threads.
+//
 // Original Author:  Chris Jones
 //         Created:  Thu Sep 11 19:24:13 EDT 2008
 //
@@ -15,11 +25,22 @@
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/CPUTimer.h"
+#include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "DataFormats/Common/interface/OutputHandle.h"
+#include "DataFormats/Provenance/interface/ParentageID.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "EventIDHash.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
 
 // user include files
 
@@ -36,6 +57,32 @@ namespace edm {
       virtual void write(EventPrincipal const& e);
       virtual void writeLuminosityBlock(LuminosityBlockPrincipal const&){}
       virtual void writeRun(RunPrincipal const&){}
+      virtual void endJob();
+
+      bool selected(EventPrincipal const& e);
+      void check(EventPrincipal const& e);
+
+      void updateBranchesInReg(ProductRegistry const& iReg);
+      std::vector<BranchID> const& parents(ProductProvenance const& iInfo);
+      void markAncestors(ProductProvenance const& iInfo,
+                         BranchMapper const& iMapper,
+                         std::map<BranchID, bool>& oMap,
+                         std::set<BranchID>& oMapperMissing);
+
+      //sorted BranchIDs of the ProductRegistry, only rebuilt if the number of products changes
+      std::vector<BranchID> branchesInReg_;
+      ProductRegistry::ProductList::size_type nProductsInReg_;
+      std::map<ParentageID, std::vector<BranchID> > parentsCache_;
+      //reused by each walk of the parentage
+      std::vector<BranchID> toVisit_;
+
+      unsigned int checkEveryNthEvent_;
+      double sampleFraction_;
+      unsigned long long hashSeed_;
+      bool reportTime_;
+      unsigned int nEvents_;
+      unsigned int nChecked_;
+      CPUTimer checkTimer_; // accumulates the wall time spent checking the selected events
    };
 
 
@@ -51,8 +98,22 @@ namespace edm {
 // constructors and destructor
 //
    ProvenanceCheckerOutputModule::ProvenanceCheckerOutputModule(ParameterSet const& pset) :
-   OutputModule(pset)
+   OutputModule(pset),
+   branchesInReg_(),
+   nProductsInReg_(0),
+   parentsCache_(),
+   toVisit_(),
+   checkEveryNthEvent_(pset.getUntrackedParameter<unsigned int>("checkEveryNthEvent")),
+   sampleFraction_(pset.getUntrackedParameter<double>("sampleFraction")),
+   hashSeed_(pset.getUntrackedParameter<unsigned int>("hashSeed")),
+   reportTime_(pset.getUntrackedParameter<bool>("reportTime")),
+   nEvents_(0),
+   nChecked_(0),
+   checkTimer_()
    {
+      if(checkEveryNthEvent_ == 0) {
+         throw edm::Exception(errors::Configuration) << "ProvenanceCheckerOutputModule: 'checkEveryNthEvent' must be at least 1.";
+      }
    }
 
 // ProvenanceCheckerOutputModule::ProvenanceCheckerOutputModule(ProvenanceCheckerOutputModule const& rhs)
@@ -76,32 +137,88 @@ namespace edm {
 //   return *this;
 // }
 
-   namespace {
-     void markAncestors(ProductProvenance const& iInfo,
-                             BranchMapper const& iMapper,
-                             std::map<BranchID, bool>& oMap,
-                             std::set<BranchID>& oMapperMissing) {
-       for(std::vector<BranchID>::const_iterator it = iInfo.parentage().parents().begin(),
-          itEnd = iInfo.parentage().parents().end();
-          it != itEnd;
-          ++it) {
+   std::vector<BranchID> const&
+   ProvenanceCheckerOutputModule::parents(ProductProvenance const& iInfo) {
+      std::map<ParentageID, std::vector<BranchID> >::iterator itFound = parentsCache_.find(iInfo.parentageID());
+      if(itFound == parentsCache_.end()) {
+         itFound = parentsCache_.insert(std::make_pair(iInfo.parentageID(), iInfo.parentage().parents())).first;
+      }
+      return itFound->second;
+   }
+
+   void
+   ProvenanceCheckerOutputModule::markAncestors(ProductProvenance const& iInfo,
+                                                BranchMapper const& iMapper,
+                                                std::map<BranchID, bool>& oMap,
+                                                std::set<BranchID>& oMapperMissing) {
+      std::vector<BranchID> const& firstParents = parents(iInfo);
+      toVisit_.assign(firstParents.begin(), firstParents.end());
+      while(!toVisit_.empty()) {
+         BranchID const branchID = toVisit_.back();
+         toVisit_.pop_back();
          //Don't look for parents if we've previously looked at the parents
-         if(oMap.find(*it) == oMap.end()) {
-            //use side effect of calling operator[] which is if the item isn't there it will add it as 'false'
-            oMap[*it];
-            ProductProvenance const* pInfo = iMapper.branchIDToProvenance(*it);
-            if(pInfo) {
-               markAncestors(*pInfo, iMapper, oMap, oMapperMissing);
-            } else {
-               oMapperMissing.insert(*it);
-            }
+         //if the item isn't there it is added as 'false'
+         if(!oMap.insert(std::make_pair(branchID, false)).second) {
+            continue;
          }
-       }
-     }
+         ProductProvenance const* pInfo = iMapper.branchIDToProvenance(branchID);
+         if(pInfo) {
+            std::vector<BranchID> const& grandParents = parents(*pInfo);
+            toVisit_.insert(toVisit_.end(), grandParents.begin(), grandParents.end());
+         } else {
+            oMapperMissing.insert(branchID);
+         }
+      }
+   }
+
+   void
+   ProvenanceCheckerOutputModule::updateBranchesInReg(ProductRegistry const& iReg) {
+      ProductRegistry::ProductList const& prodList = iReg.productList();
+      if(prodList.size() == nProductsInReg_) {
+         return;
+      }
+      branchesInReg_.clear();
+      branchesInReg_.reserve(prodList.size());
+      for(ProductRegistry::ProductList::const_iterator it = prodList.begin(), itEnd = prodList.end();
+          it != itEnd;
+          ++it) {
+         branchesInReg_.push_back(it->second.branchID());
+      }
+      std::sort(branchesInReg_.begin(), branchesInReg_.end());
+      nProductsInReg_ = prodList.size();
+   }
+
+   bool
+   ProvenanceCheckerOutputModule::selected(EventPrincipal const& e) {
+      ++nEvents_;
+      if((nEvents_ - 1) % checkEveryNthEvent_ != 0) {
+         return false;
+      }
+      return sampleFraction_ >= 1. || uniformFromEventID(e.id(), hashSeed_) < sampleFraction_;
    }
 
    void
    ProvenanceCheckerOutputModule::write(EventPrincipal const& e) {
+      if(!selected(e)) {
+         return;
+      }
+      ++nChecked_;
+      checkTimer_.start();
+      check(e);
+      checkTimer_.stop();
+   }
+
+   void
+   ProvenanceCheckerOutputModule::endJob() {
+      if(reportTime_) {
+         LogSystem("ProvenanceChecker") << "Checked " << nChecked_ << " of " << nEvents_ << " events in "
+                                        << checkTimer_.realTime() << " s of wall time, "
+                                        << (nChecked_ ? checkTimer_.realTime() / nChecked_ * 1e6 : 0.) << " us per checked event.";
+      }
+   }
+
+   void
+   ProvenanceCheckerOutputModule::check(EventPrincipal const& e) {
       //check ProductProvenance's parents to see if they are in the ProductProvenance list
       boost::shared_ptr<BranchMapper> mapperPtr = e.branchMapperPtr();
 
@@ -140,14 +257,7 @@ namespace edm {
       }
 
       //Determine what BranchIDs are in the product registry
-      ProductRegistry const& reg = e.productRegistry();
-      ProductRegistry::ProductList const prodList = reg.productList();
-      std::set<BranchID> branchesInReg;
-      for(ProductRegistry::ProductList::const_iterator it = prodList.begin(), itEnd = prodList.end();
-          it != itEnd;
-          ++it) {
-         branchesInReg.insert(it->second.branchID());
-      }
+      updateBranchesInReg(e.productRegistry());
 
       std::set<BranchID> missingFromPrincipal;
       std::set<BranchID> missingFromReg;
@@ -157,7 +267,7 @@ namespace edm {
          if(!it->second) {
             missingFromPrincipal.insert(it->first);
          }
-         if(branchesInReg.find(it->first) == branchesInReg.end()) {
+         if(!std::binary_search(branchesInReg_.begin(), branchesInReg_.end(), it->first)) {
             missingFromReg.insert(it->first);
          }
       }
@@ -219,6 +329,13 @@ namespace edm {
   void
   ProvenanceCheckerOutputModule::fillDescriptions(ConfigurationDescriptions& descriptions) {
     ParameterSetDescription desc;
+    desc.addUntracked<unsigned int>("checkEveryNthEvent", 1)->setComment("Only check one event out of this many, counting from the first event.");
+    desc.addUntracked<double>("sampleFraction", 1.)->setComment("If less than 1, only check the events for which a hash of the EventID, "
+                                                                "seen as a number in [0,1), is below this value. "
+                                                                "The same events are selected whatever the order in which they are processed. "
+                                                                "Combined with 'checkEveryNthEvent', an event must pass both.");
+    desc.addUntracked<unsigned int>("hashSeed", 0)->setComment("Seed combined with the EventID when 'sampleFraction' is used.");
+    desc.addUntracked<bool>("reportTime", false)->setComment("At the end of the job, report the number of checked events and the wall time spent checking them.");
     OutputModule::fillDescription(desc);
     descriptions.add("provenanceChecker", desc);
   }
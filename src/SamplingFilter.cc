@@ -0,0 +1,118 @@
+
+#include "FWCore/Framework/interface/EDFilter.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/ErrorSummaryEntry.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "EventIDHash.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace edm {
+  // Accepts events with a probability depending on a per event weight: either a
+  // double read from the Event or the number of errors and warnings found by
+  // LogErrorHarvester. The weight picks a stratum from 'thresholds' and each stratum
+  // has its own acceptance probability. The random number comes from a hash of the
+  // EventID so, as for Prescaler with 'useEventIDHash', whether an event passes the
+  // probability cut does not depend on the order in which the events are processed.
+  // 'maxAcceptedPerLuminosityBlock' then keeps the first events to pass in each
+  // luminosity block, so with that limit the accepted events do depend on the order.
+  class SamplingFilter : public EDFilter {
+  public:
+    explicit SamplingFilter(ParameterSet const&);
+    virtual ~SamplingFilter();
+
+    static void fillDescriptions(ConfigurationDescriptions& descriptions);
+    virtual bool filter(Event& e, EventSetup const& c);
+    virtual void beginLuminosityBlock(LuminosityBlock const& lb, EventSetup const& c);
+
+  private:
+    double getWeight(Event const& e) const;
+
+    InputTag weightTag_;
+    InputTag harvesterTag_;
+    std::vector<double> thresholds_;
+    std::vector<double> probabilities_; // one more than thresholds_
+    unsigned long long seed_;
+    unsigned int maxPerLumi_; // 0 means no limit
+    unsigned int acceptedInLumi_;
+  };
+
+  SamplingFilter::SamplingFilter(ParameterSet const& ps) :
+    weightTag_(ps.getParameter<InputTag>("weightTag")),
+    harvesterTag_(ps.getParameter<InputTag>("harvesterTag")),
+    thresholds_(ps.getParameter<std::vector<double> >("thresholds")),
+    probabilities_(ps.getParameter<std::vector<double> >("acceptProbabilities")),
+    seed_(ps.getParameter<unsigned int>("seed")),
+    maxPerLumi_(ps.getParameter<unsigned int>("maxAcceptedPerLuminosityBlock")),
+    acceptedInLumi_(0) {
+    if(weightTag_.label().empty() == harvesterTag_.label().empty()) {
+      throw edm::Exception(errors::Configuration) << "SamplingFilter: exactly one of 'weightTag' and 'harvesterTag' must be set.\n";
+    }
+    if(probabilities_.size() != thresholds_.size() + 1) {
+      throw edm::Exception(errors::Configuration) << "SamplingFilter: 'acceptProbabilities' must have exactly one more entry than 'thresholds' but has "
+        << probabilities_.size() << " entries for " << thresholds_.size() << " thresholds.\n";
+    }
+    if(!std::is_sorted(thresholds_.begin(), thresholds_.end())) {
+      throw edm::Exception(errors::Configuration) << "SamplingFilter: 'thresholds' must be in increasing order.\n";
+    }
+  }
+
+  SamplingFilter::~SamplingFilter() {
+  }
+
+  // a missing product throws ProductNotFound when the Handle is dereferenced
+  double SamplingFilter::getWeight(Event const& e) const {
+    if(!weightTag_.label().empty()) {
+      Handle<double> value;
+      e.getByLabel(weightTag_, value);
+      return *value;
+    }
+    Handle<std::vector<ErrorSummaryEntry> > errorsAndWarnings;
+    e.getByLabel(harvesterTag_, errorsAndWarnings);
+    double weight = 0.;
+    for(std::vector<ErrorSummaryEntry>::const_iterator it = errorsAndWarnings->begin(), itEnd = errorsAndWarnings->end(); it != itEnd; ++it) {
+      weight += it->count;
+    }
+    return weight;
+  }
+
+  bool SamplingFilter::filter(Event& e, EventSetup const&) {
+    if(maxPerLumi_ != 0 && acceptedInLumi_ >= maxPerLumi_) {
+      return false;
+    }
+    double const weight = getWeight(e);
+    unsigned int const stratum = std::upper_bound(thresholds_.begin(), thresholds_.end(), weight) - thresholds_.begin();
+    if(uniformFromEventID(e.id(), seed_) >= probabilities_[stratum]) {
+      return false;
+    }
+    ++acceptedInLumi_;
+    return true;
+  }
+
+  void SamplingFilter::beginLuminosityBlock(LuminosityBlock const&, EventSetup const&) {
+    acceptedInLumi_ = 0;
+  }
+
+  void
+  SamplingFilter::fillDescriptions(ConfigurationDescriptions& descriptions) {
+    ParameterSetDescription desc;
+    desc.add<InputTag>("weightTag", InputTag())->setComment("A 'double' in the Event used as the weight. Leave empty when using 'harvesterTag'.");
+    desc.add<InputTag>("harvesterTag", InputTag())->setComment("The LogErrorHarvester product. The weight is the number of errors and warnings it holds. Leave empty when using 'weightTag'.");
+    desc.add<std::vector<double> >("thresholds", std::vector<double>())->setComment("Increasing weight boundaries between strata. A weight equal to a threshold belongs to the stratum above it.");
+    desc.add<std::vector<double> >("acceptProbabilities", std::vector<double>(1, 1.))->setComment("Probability to accept an event in each stratum, one more entry than 'thresholds'.");
+    desc.add<unsigned int>("seed", 0)->setComment("Seed combined with the EventID to make the random decisions.");
+    desc.add<unsigned int>("maxAcceptedPerLuminosityBlock", 0)->setComment("Accept at most this many events in each luminosity block. 0 means no limit. "
+                                                                           "The first events to pass in a luminosity block are kept, so with a limit "
+                                                                           "the accepted events depend on the order in which the events are processed.");
+    descriptions.add("samplingFilter", desc);
+  }
+}
+
+using edm::SamplingFilter;
+DEFINE_FWK_MODULE(SamplingFilter);
@@ -0,0 +1,130 @@
+
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/InputSourceMacros.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Sources/interface/ProducerSourceBase.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+#include "EventIDHash.h"
+
+#include <cmath>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace edm {
+  namespace {
+    // xorshift64*, small and identical on every platform
+    class PayloadRandom {
+    public:
+      explicit PayloadRandom(unsigned long long iSeed) : state_(iSeed ? iSeed : 0x9e3779b97f4a7c15ULL) {}
+      unsigned long long next() {
+        state_ ^= state_ >> 12;
+        state_ ^= state_ << 25;
+        state_ ^= state_ >> 27;
+        return state_ * 2685821657736338717ULL;
+      }
+      // uniform in [0,1)
+      double flat() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    private:
+      unsigned long long state_;
+    };
+  }
+
+  class SyntheticPayloadSource : public ProducerSourceBase {
+  public:
+    explicit SyntheticPayloadSource(ParameterSet const&, InputSourceDescription const&);
+    ~SyntheticPayloadSource();
+    static void fillDescriptions(ConfigurationDescriptions& descriptions);
+  private:
+    enum SizeDistribution { kFixed, kUniform, kExponential };
+
+    virtual bool setRunAndEventInfo(EventID& id, TimeValue_t& time);
+    virtual void produce(Event &);
+    unsigned int payloadSize(PayloadRandom& random) const;
+
+    std::vector<std::string> labels_;
+    unsigned int meanSize_;
+    SizeDistribution distribution_;
+    unsigned long long seed_;
+  };
+
+  SyntheticPayloadSource::SyntheticPayloadSource(ParameterSet const& pset,
+                                                 InputSourceDescription const& desc) :
+    ProducerSourceBase(pset, desc, false),
+    labels_(),
+    meanSize_(pset.getParameter<unsigned int>("meanPayloadSize")),
+    distribution_(kFixed),
+    seed_(pset.getParameter<unsigned int>("seed")) {
+    std::string const distribution = pset.getParameter<std::string>("payloadSizeDistribution");
+    if(distribution == "uniform") {
+      distribution_ = kUniform;
+    } else if(distribution == "exponential") {
+      distribution_ = kExponential;
+    } else if(distribution != "fixed") {
+      throw edm::Exception(errors::Configuration) << "SyntheticPayloadSource: unknown 'payloadSizeDistribution' \"" << distribution
+        << "\". Allowed values are fixed, uniform and exponential.\n";
+    }
+    unsigned int const nBranches = pset.getParameter<unsigned int>("numberOfBranches");
+    for(unsigned int i = 0; i != nBranches; ++i) {
+      std::ostringstream label;
+      label << "payload" << i;
+      labels_.push_back(label.str());
+      produces<std::vector<double> >(labels_.back());
+    }
+  }
+
+  SyntheticPayloadSource::~SyntheticPayloadSource() {
+  }
+
+  bool
+  SyntheticPayloadSource::setRunAndEventInfo(EventID&, TimeValue_t&) {
+    return true;
+  }
+
+  unsigned int
+  SyntheticPayloadSource::payloadSize(PayloadRandom& random) const {
+    switch(distribution_) {
+      case kUniform:
+        return static_cast<unsigned int>(random.flat() * (2 * meanSize_ + 1));
+      case kExponential:
+        return static_cast<unsigned int>(-std::log(1. - random.flat()) * meanSize_);
+      case kFixed:
+        break;
+    }
+    return meanSize_;
+  }
+
+  void
+  SyntheticPayloadSource::produce(edm::Event& e) {
+    //the content only depends on the EventID and the seed, not on the order events are made
+    for(unsigned int i = 0; i != labels_.size(); ++i) {
+      PayloadRandom random(hashEventID(e.id(), seed_ + i));
+      std::auto_ptr<std::vector<double> > payload(new std::vector<double>(payloadSize(random)));
+      for(std::vector<double>::iterator it = payload->begin(), itEnd = payload->end(); it != itEnd; ++it) {
+        *it = random.flat();
+      }
+      e.put(payload, labels_[i]);
+    }
+  }
+
+  void
+  SyntheticPayloadSource::fillDescriptions(ConfigurationDescriptions& descriptions) {
+    ParameterSetDescription desc;
+    desc.setComment("Creates runs, lumis and events like EmptySource, each event holding 'numberOfBranches' std::vector<double> "
+                    "products labelled payload0, payload1, ... filled with pseudo-random values. Intended for throughput benchmarks.");
+    desc.add<unsigned int>("numberOfBranches", 1)->setComment("Number of products put in each event.");
+    desc.add<unsigned int>("meanPayloadSize", 100)->setComment("Mean number of elements in each product.");
+    desc.add<std::string>("payloadSizeDistribution", "fixed")->setComment("How the number of elements varies from product to product: "
+                                                                           "'fixed', 'uniform' between 0 and twice the mean, or 'exponential'.");
+    desc.add<unsigned int>("seed", 0)->setComment("Seed for the content. The same seed and EventID always give the same products.");
+    ProducerSourceBase::fillDescription(desc);
+    descriptions.add("syntheticPayloadSource", desc);
+  }
+}
+
+using edm::SyntheticPayloadSource;
+DEFINE_FWK_INPUT_SOURCE(SyntheticPayloadSource);
@@ -4,11 +4,28 @@ function die { echo $1: status $2; exit $2; }
 
 cmsRun ${LOCAL_TEST_DIR}/ContentTest_cfg.py || die 'failed running cmsRun ContentTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/printeventsetupcontent_cfg.py || die 'failed running cmsRun printeventsetupcontent_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/printeventsetupcontenttimeline_cfg.py || die 'failed running cmsRun printeventsetupcontenttimeline_cfg.py' $?
+edmEventSetupTimeline.py estimeline.txt || die 'failed running edmEventSetupTimeline.py' $?
 cmsRun ${LOCAL_TEST_DIR}/geteventsetupcontent_cfg.py || die 'failed running cmsRun geteventsetupcontent_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/warmupeventsetup_cfg.py || die 'failed running cmsRun warmupeventsetup_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/checkcacheidentifier_cfg.py || die 'failed running cmsRun checkcacheidentifier_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/checkcacheidentifierfile_cfg.py record || die 'failed running cmsRun checkcacheidentifierfile_cfg.py record' $?
+cmsRun ${LOCAL_TEST_DIR}/checkcacheidentifierfile_cfg.py check || die 'failed running cmsRun checkcacheidentifierfile_cfg.py check' $?
+cmsRun ${LOCAL_TEST_DIR}/checkcacheidentifierfile_cfg.py mismatch > checkcacheidentifiermismatch.log 2>&1 && die 'cmsRun checkcacheidentifierfile_cfg.py mismatch did not fail as it should' 1
+grep -q IncorrectCacheID checkcacheidentifiermismatch.log || die 'cmsRun checkcacheidentifierfile_cfg.py mismatch did not fail with IncorrectCacheID' 1
+cmsRun ${LOCAL_TEST_DIR}/emptyessource_iov_cfg.py || die 'failed running cmsRun emptyessource_iov_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/emptyessource_lumi_cfg.py || die 'failed running cmsRun emptyessource_lumi_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/emptysource_multiprocess_cfg.py || die 'failed running cmsRun emptysource_multiprocess_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/multiprocess_failedChild_cfg.py && die 'cmsRun multiprocess_failedChild_cfg.py did not fail as it should' $?
 cmsRun ${LOCAL_TEST_DIR}/multiprocess_failedChild_and_continue_cfg.py || 'failed running multiprocess_failedChild_and_continue_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/multiprocess_failedChild_exception_cfg.py && die 'cmsRun multiprocess_failedChild_exception_cfg.py did not fail as it should' $?
 cmsRun ${LOCAL_TEST_DIR}/multiprocess_failedChild_exception_and_continue_cfg.py || 'failed running multiprocess_failedChild_exception_and_continue_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/logErrorHarvester_cfg.py || die 'failed running cmsRun logErrorHarvester_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/logErrorHarvesterTiming_cfg.py || die 'failed running cmsRun logErrorHarvesterTiming_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/testPrescaler_cfg.py || die 'failed running cmsRun testPrescaler_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/testPrescaler_cfg.py reversed || die 'failed running cmsRun testPrescaler_cfg.py reversed' $?
+cmsRun ${LOCAL_TEST_DIR}/syntheticpayloadsource_cfg.py || die 'failed running cmsRun syntheticpayloadsource_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/eventidlistsource_cfg.py || die 'failed running cmsRun eventidlistsource_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/eventAuxiliaryHistoryColumns_cfg.py || die 'failed running cmsRun eventAuxiliaryHistoryColumns_cfg.py' $?
+cmsRun ${LOCAL_TEST_DIR}/emptysource_transitions_cfg.py || die 'failed running cmsRun emptysource_transitions_cfg.py' $?
 
@@ -20,4 +20,10 @@ process.checker = cms.EDAnalyzer("EventSetupCacheIdentifierChecker",
                               GadgetRcd = cms.untracked.vuint32(2,2,2,2,2,2,2,2,2,3,3,3)
 )
 
-process.p = cms.Path(process.checker)
+process.encodedChecker = cms.EDAnalyzer("EventSetupCacheIdentifierChecker",
+                              runLengthEncoded = cms.untracked.PSet(
+                                  GadgetRcd = cms.untracked.vuint32(2,9, 3,3)
+                              )
+)
+
+process.p = cms.Path(process.checker+process.encodedChecker)
@@ -0,0 +1,49 @@
+# Records the cacheIdentifiers of all Records to a file, or checks them against that file.
+# Usage: cmsRun checkcacheidentifierfile_cfg.py record|check|mismatch
+# 'mismatch' checks against a copy of the file with one cacheIdentifier changed and must fail.
+
+import struct
+import sys
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("Demo")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(4)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(1)
+)
+
+process.MessageLogger = cms.Service("MessageLogger")
+
+process.WhatsItESProducer = cms.ESProducer("WhatsItESProducer")
+
+process.DoodadESSource = cms.ESSource("DoodadESSource")
+
+process.checker = cms.EDAnalyzer("EventSetupCacheIdentifierChecker")
+mode = 'record'
+if len(sys.argv) > 2:
+   mode = sys.argv[2]
+if mode == 'check':
+   process.checker.checkAgainstFile = cms.untracked.string('cacheidentifiers.bin')
+elif mode == 'mismatch':
+   # header (magic, number of records, number of transitions), then for each record
+   # its name length and the name padded to 4 bytes, then the cacheIdentifiers
+   data = bytearray(open('cacheidentifiers.bin', 'rb').read())
+   (magic, nRecords, nTransitions) = struct.unpack_from('=III', data, 0)
+   offset = 12
+   for i in range(nRecords):
+      (length,) = struct.unpack_from('=I', data, offset)
+      offset += 4 + (length + 3)//4*4
+   # 0 means the record was not available and is not compared, so change a non zero value
+   while struct.unpack_from('=I', data, offset)[0] == 0:
+      offset += 4
+   struct.pack_into('=I', data, offset, struct.unpack_from('=I', data, offset)[0] + 100)
+   open('cacheidentifiersmismatch.bin', 'wb').write(data)
+   process.checker.checkAgainstFile = cms.untracked.string('cacheidentifiersmismatch.bin')
+else:
+   process.checker.recordToFile = cms.untracked.string('cacheidentifiers.bin')
+
+process.p = cms.Path(process.checker)
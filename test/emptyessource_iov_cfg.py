@@ -0,0 +1,50 @@
+# Checks the IOVs EmptyESSource gives when the runs are not in increasing order and
+# when a run comes before the first IOV
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# one event per run, run 1 is before the first IOV
+runs = [3, 1, 5, 2, 4]
+
+listFile = open('emptyessourceiov.txt', 'w')
+listFile.write('# run lumi event\n')
+for run in runs:
+   listFile.write('%d 1 1\n' % run)
+listFile.close()
+
+process.source = cms.Source("EventIDListSource",
+    fileName = cms.untracked.string('emptyessourceiov.txt')
+)
+
+process.EmptyESSourceTestProducer = cms.ESProducer("EmptyESSourceTestProducer")
+
+process.iovA = cms.ESSource("EmptyESSource",
+    recordName = cms.string("EmptyESSourceTestRecordA"),
+    iovIsRunNotTime = cms.bool(True),
+    firstValid = cms.vuint32(2,4),
+    # shares the IOVs of EmptyESSourceTestRecordA
+    additionalRecordNames = cms.vstring("EmptyESSourceTestRecordB"),
+    # has its own IOVs
+    records = cms.VPSet(
+        cms.PSet(
+            recordName = cms.string("EmptyESSourceTestRecordC"),
+            iovIsRunNotTime = cms.bool(True),
+            firstValid = cms.vuint32(1,3)
+        )
+    )
+)
+
+# one value for each beginRun, beginLuminosityBlock and event, 0 while the record is not available
+# run 3: [2,3], run 1: none, run 5: [4,...), run 2: [2,3] again, run 4: [4,...) again
+process.checker = cms.EDAnalyzer("EventSetupCacheIdentifierChecker",
+    EmptyESSourceTestRecordA = cms.untracked.vuint32(2,2,2, 0,0,0, 3,3,3, 4,4,4, 5,5,5),
+    EmptyESSourceTestRecordB = cms.untracked.vuint32(2,2,2, 0,0,0, 3,3,3, 4,4,4, 5,5,5),
+    # run 3: [3,...), run 1: [1,2], run 5: [3,...) again, run 2: [1,2] again, run 4: [3,...) again
+    EmptyESSourceTestRecordC = cms.untracked.vuint32(2,2,2, 3,3,3, 4,4,4, 5,5,5, 6,6,6)
+)
+
+process.p = cms.Path(process.checker)
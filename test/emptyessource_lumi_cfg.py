@@ -0,0 +1,42 @@
+# Checks EmptyESSource IOVs starting at a luminosity block, given both in the
+# configuration and in a binary 'firstValidFile'
+
+import struct
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# native 32 bit run and luminosity block numbers
+iovFile = open('emptyessourceiov.bin', 'wb')
+iovFile.write(struct.pack('=II', 1, 5))
+iovFile.close()
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(6)
+)
+
+# run 1 with luminosity blocks 1 to 6, one event each
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(1)
+)
+
+process.EmptyESSourceTestProducer = cms.ESProducer("EmptyESSourceTestProducer")
+
+# IOVs 1:0 to 1:2, 1:3 to 1:4 and 1:5 onwards, each one ending at the
+# maximum event number of the luminosity block before the next one starts
+process.iovA = cms.ESSource("EmptyESSource",
+    recordName = cms.string("EmptyESSourceTestRecordA"),
+    iovIsRunNotTime = cms.bool(True),
+    firstValid = cms.vuint32(1,1),
+    firstValidLuminosityBlock = cms.vuint32(0,3),
+    firstValidFile = cms.string('emptyessourceiov.bin')
+)
+
+# beginRun, then beginLuminosityBlock and event for each luminosity block
+process.checker = cms.EDAnalyzer("EventSetupCacheIdentifierChecker",
+    EmptyESSourceTestRecordA = cms.untracked.vuint32(2, 2,2, 2,2, 3,3, 3,3, 4,4, 4,4)
+)
+
+process.p = cms.Path(process.checker)
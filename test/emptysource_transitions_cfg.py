@@ -0,0 +1,30 @@
+# Measures the framework's run and luminosity block transition overhead.
+# Usage: cmsRun emptysource_transitions_cfg.py [tinyLumis|tinyRuns|longRuns]
+
+import sys
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# events per run and per luminosity block for each pattern
+patterns = {
+    'tinyLumis': (1000, 1),
+    'tinyRuns':  (1, 1),
+    'longRuns':  (0, 1000)
+}
+pattern = 'tinyLumis'
+if len(sys.argv) > 2:
+   pattern = sys.argv[2]
+(eventsInRun, eventsInLumi) = patterns[pattern]
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(10000)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(eventsInRun),
+    numberEventsInLuminosityBlock = cms.untracked.uint32(eventsInLumi),
+    reportTransitionTimes = cms.untracked.bool(True)
+)
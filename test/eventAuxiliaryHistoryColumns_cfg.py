@@ -0,0 +1,34 @@
+# Checks the column products of EventAuxiliaryHistoryProducer against its
+# std::vector<EventAuxiliary> product
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# the history grows up to its depth, restarts after the gaps in the event numbers and
+# at the new run, and goes on across the luminosity block change
+sequence = [(1,1,1), (1,1,2), (1,1,3), (1,1,4), (1,1,5), (1,1,8), (1,1,9), (1,2,10), (1,2,11), (1,2,12), (2,1,1), (2,1,2)]
+
+listFile = open('eventauxiliaryhistory.txt', 'w')
+listFile.write('# run lumi event\n')
+for entry in sequence:
+   listFile.write('%d %d %d\n' % entry)
+listFile.close()
+
+process.source = cms.Source("EventIDListSource",
+    fileName = cms.untracked.string('eventauxiliaryhistory.txt')
+)
+
+process.auxColumns = cms.EDProducer("EventAuxiliaryHistoryProducer",
+    historyDepth = cms.uint32(3),
+    columns = cms.vstring('run', 'luminosityBlock', 'event', 'time', 'bunchCrossing', 'orbitNumber')
+)
+
+process.check = cms.EDAnalyzer("EventAuxiliaryHistoryChecker",
+    src = cms.untracked.string('auxColumns'),
+    historyDepth = cms.untracked.uint32(3)
+)
+
+process.p = cms.Path(process.auxColumns+process.check)
@@ -0,0 +1,48 @@
+# Configuration file for EventIDListSource
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+# irregular lumi sizes, a gap in the event numbers, a run change and a time going backwards
+sequence = [(1,1,1,1000), (1,1,2,1010), (1,2,3,1005), (1,2,7,1020), (1,2,8,1030), (1,5,9,1040), (2,1,1,900), (2,1,2,950)]
+
+listFile = open('eventidlist.txt', 'w')
+listFile.write('# run lumi event time\n')
+for entry in sequence:
+   listFile.write('%d %d %d %d\n' % entry)
+listFile.close()
+
+process.source = cms.Source("EventIDListSource",
+    fileName = cms.untracked.string('eventidlist.txt')
+)
+
+ids = cms.VEventID()
+for (run, lumi, event, time) in sequence:
+   ids.append(cms.EventID(run, event))
+process.check = cms.EDAnalyzer("EventIDChecker", eventSequence = cms.untracked(ids))
+
+# EventIDChecker ignores the luminosity blocks, this also checks the run and
+# luminosity block transitions: (run,0,0) for a run and (run,lumi,0) for a lumi
+transitions = []
+for index, (run, lumi, event, time) in enumerate(sequence):
+   if index == 0 or sequence[index-1][0:2] != (run, lumi):
+      if index != 0:
+         (previousRun, previousLumi) = sequence[index-1][0:2]
+         transitions.append((previousRun, previousLumi, 0))
+         if previousRun != run:
+            transitions.append((previousRun, 0, 0))
+      if index == 0 or sequence[index-1][0] != run:
+         transitions.append((run, 0, 0))
+      transitions.append((run, lumi, 0))
+   transitions.append((run, lumi, event))
+transitions.append((sequence[-1][0], sequence[-1][1], 0))
+transitions.append((sequence[-1][0], 0, 0))
+process.checkTransitions = cms.EDAnalyzer("MulticoreRunLumiEventChecker",
+    eventSequence = cms.untracked.VEventID([cms.EventID(*transition) for transition in transitions])
+)
+process.print1 = cms.OutputModule("AsciiOutputModule")
+
+process.p = cms.EndPath(process.check+process.checkTransitions+process.print1)
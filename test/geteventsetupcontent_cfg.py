@@ -21,4 +21,10 @@ process.demo = cms.EDAnalyzer("EventSetupRecordDataGetter",
                               verbose = cms.untracked.bool(True)
 )
 
-process.p = cms.Path(process.demo)
+process.demoProfile = cms.EDAnalyzer("EventSetupRecordDataGetter",
+                              toGet = cms.VPSet(), #empty means get them all
+                              verbose = cms.untracked.bool(True),
+                              profile = cms.untracked.bool(True)
+)
+
+process.p = cms.Path(process.demo+process.demoProfile)
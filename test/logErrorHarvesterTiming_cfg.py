@@ -0,0 +1,62 @@
+# Measures the per-event cost of LogErrorHarvester in its different modes.
+# The Timing service summary printed at the end of the job gives the
+# average time spent in each module. It shows the cost of each mode, there is
+# no other implementation to compare it with in the same job.
+# Each harvester takes the messages logged since the previous one ran, so each
+# is preceded by its own LogErrorEmitter to measure the case with errors.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(10000)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(100)
+)
+
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+# the emitted messages are only wanted by the harvesters, not in the job output
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring("cout"),
+    categories = cms.untracked.vstring("TimingErr", "TimingWarnA", "TimingWarnB"),
+    cout = cms.untracked.PSet(
+        TimingErr = cms.untracked.PSet(limit = cms.untracked.int32(0)),
+        TimingWarnA = cms.untracked.PSet(limit = cms.untracked.int32(0)),
+        TimingWarnB = cms.untracked.PSet(limit = cms.untracked.int32(0))
+    )
+)
+
+emitter = cms.EDAnalyzer("LogErrorEmitter",
+    errorCategories = cms.untracked.vstring("TimingErr"),
+    warningCategories = cms.untracked.vstring("TimingWarnA", "TimingWarnB")
+)
+
+# without any logged message
+process.perEventEmpty = cms.EDProducer("LogErrorHarvester")
+
+process.emitPerEvent = emitter.clone()
+process.perEvent = cms.EDProducer("LogErrorHarvester")
+
+process.emitPerLumi = emitter.clone()
+process.perLumi = cms.EDProducer("LogErrorHarvester",
+    perEvent = cms.bool(False),
+    perLuminosityBlock = cms.bool(True)
+)
+
+process.emitBoth = emitter.clone()
+process.both = cms.EDProducer("LogErrorHarvester",
+    perLuminosityBlock = cms.bool(True)
+)
+
+process.p = cms.Path(process.perEventEmpty+
+                     process.emitPerEvent+process.perEvent+
+                     process.emitPerLumi+process.perLumi+
+                     process.emitBoth+process.both)
@@ -0,0 +1,101 @@
+# Checks the entries LogErrorHarvester puts into the Event and the LuminosityBlock.
+# Each path has its own LogErrorEmitter since a harvester takes all the messages
+# logged since the previous harvester ran.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(6)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(3)
+)
+
+emitter = cms.EDAnalyzer("LogErrorEmitter",
+    errorCategories = cms.untracked.vstring("ErrA", "ErrB"),
+    warningCategories = cms.untracked.vstring("WarnA", "WarnB", "WarnC")
+)
+
+allCategories = cms.untracked.vstring("ErrA", "ErrB", "WarnA", "WarnB", "WarnC")
+allSeverities = cms.untracked.vstring("ERROR", "ERROR", "WARNING", "WARNING", "WARNING")
+
+# no limit, entries also summed over the luminosity block
+process.emitPerLumi = emitter.clone()
+process.harvestPerLumi = cms.EDProducer("LogErrorHarvester",
+    perLuminosityBlock = cms.bool(True)
+)
+process.checkPerLumi = cms.EDAnalyzer("LogErrorHarvesterChecker",
+    src = cms.untracked.InputTag("harvestPerLumi"),
+    categories = allCategories,
+    severities = allSeverities,
+    counts = cms.untracked.vuint32(1, 1, 1, 1, 1),
+    lumiSrc = cms.untracked.InputTag("harvestPerLumi"),
+    lumiCategories = allCategories,
+    lumiSeverities = allSeverities,
+    lumiCounts = cms.untracked.vuint32(3, 3, 3, 3, 3)
+)
+process.pPerLumi = cms.Path(process.emitPerLumi+process.harvestPerLumi+process.checkPerLumi)
+
+# at most 3 entries: the 2 errors are kept, the 3 warnings become one overflow entry
+# the LuminosityBlock sums are made before the truncation
+process.emitMax3 = emitter.clone()
+process.harvestMax3 = cms.EDProducer("LogErrorHarvester",
+    perLuminosityBlock = cms.bool(True),
+    maxEntriesPerEvent = cms.uint32(3)
+)
+process.checkMax3 = cms.EDAnalyzer("LogErrorHarvesterChecker",
+    src = cms.untracked.InputTag("harvestMax3"),
+    categories = cms.untracked.vstring("ErrA", "ErrB", "LogErrorHarvesterOverflow"),
+    severities = cms.untracked.vstring("ERROR", "ERROR", "WARNING"),
+    counts = cms.untracked.vuint32(1, 1, 3),
+    lumiSrc = cms.untracked.InputTag("harvestMax3"),
+    lumiCategories = allCategories,
+    lumiSeverities = allSeverities,
+    lumiCounts = cms.untracked.vuint32(3, 3, 3, 3, 3)
+)
+process.pMax3 = cms.Path(process.emitMax3+process.harvestMax3+process.checkMax3)
+
+# a single entry can only be the overflow entry, with the most severe level
+process.emitMax1 = emitter.clone()
+process.harvestMax1 = cms.EDProducer("LogErrorHarvester",
+    maxEntriesPerEvent = cms.uint32(1)
+)
+process.checkMax1 = cms.EDAnalyzer("LogErrorHarvesterChecker",
+    src = cms.untracked.InputTag("harvestMax1"),
+    categories = cms.untracked.vstring("LogErrorHarvesterOverflow"),
+    severities = cms.untracked.vstring("ERROR"),
+    counts = cms.untracked.vuint32(5)
+)
+process.pMax1 = cms.Path(process.emitMax1+process.harvestMax1+process.checkMax1)
+
+# a byte limit smaller than the overflow entry still leaves the overflow entry
+process.emitMaxBytes = emitter.clone()
+process.harvestMaxBytes = cms.EDProducer("LogErrorHarvester",
+    maxBytesPerEvent = cms.uint32(1)
+)
+process.checkMaxBytes = cms.EDAnalyzer("LogErrorHarvesterChecker",
+    src = cms.untracked.InputTag("harvestMaxBytes"),
+    categories = cms.untracked.vstring("LogErrorHarvesterOverflow"),
+    severities = cms.untracked.vstring("ERROR"),
+    counts = cms.untracked.vuint32(5)
+)
+process.pMaxBytes = cms.Path(process.emitMaxBytes+process.harvestMaxBytes+process.checkMaxBytes)
+
+# nothing logged, nothing to truncate
+process.harvestNothing = cms.EDProducer("LogErrorHarvester",
+    maxEntriesPerEvent = cms.uint32(1)
+)
+process.checkNothing = cms.EDAnalyzer("LogErrorHarvesterChecker",
+    src = cms.untracked.InputTag("harvestNothing"),
+    categories = cms.untracked.vstring(),
+    severities = cms.untracked.vstring(),
+    counts = cms.untracked.vuint32()
+)
+process.pNothing = cms.Path(process.harvestNothing+process.checkNothing)
+
+process.schedule = cms.Schedule(process.pPerLumi, process.pMax3, process.pMax1, process.pMaxBytes, process.pNothing)
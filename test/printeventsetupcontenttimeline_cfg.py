@@ -0,0 +1,23 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("Demo")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(3)
+)
+
+process.MessageLogger = cms.Service("MessageLogger")
+
+process.WhatsItESProducer = cms.ESProducer("WhatsItESProducer")
+
+process.DoodadESSource = cms.ESSource("DoodadESSource")
+
+process.demo = cms.EDAnalyzer("PrintEventSetupContent",
+    timelineFile = cms.untracked.string("estimeline.txt")
+)
+
+process.p = cms.Path(process.demo)
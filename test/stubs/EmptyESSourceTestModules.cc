@@ -0,0 +1,60 @@
+// -*- C++ -*-
+//
+// Package:     Modules
+// Class  :     EmptyESSourceTestRecordA, B and C, EmptyESSourceTestProducer
+//
+// Implementation:
+//     Records whose IOVs only come from EmptyESSource, so a test can check the
+//     intervals it gives with EventSetupCacheIdentifierChecker. The producer puts
+//     a small data item in each of them so the records exist in the job.
+//
+
+// system include files
+#include <memory>
+
+// user include files
+#include "FWCore/Framework/interface/ESProducer.h"
+#include "FWCore/Framework/interface/EventSetupRecordImplementation.h"
+#include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Framework/interface/eventsetuprecord_registration_macro.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/typelookup.h"
+
+//the record names are used as parameter labels by EventSetupCacheIdentifierChecker so no namespace
+class EmptyESSourceTestRecordA : public edm::eventsetup::EventSetupRecordImplementation<EmptyESSourceTestRecordA> {};
+class EmptyESSourceTestRecordB : public edm::eventsetup::EventSetupRecordImplementation<EmptyESSourceTestRecordB> {};
+class EmptyESSourceTestRecordC : public edm::eventsetup::EventSetupRecordImplementation<EmptyESSourceTestRecordC> {};
+
+struct EmptyESSourceTestData {
+  int value_;
+};
+
+namespace edmtest {
+  class EmptyESSourceTestProducer : public edm::ESProducer {
+  public:
+    explicit EmptyESSourceTestProducer(edm::ParameterSet const&) {
+      setWhatProduced(this, &EmptyESSourceTestProducer::produceA);
+      setWhatProduced(this, &EmptyESSourceTestProducer::produceB);
+      setWhatProduced(this, &EmptyESSourceTestProducer::produceC);
+    }
+
+    std::auto_ptr<EmptyESSourceTestData> produceA(EmptyESSourceTestRecordA const&) { return make(); }
+    std::auto_ptr<EmptyESSourceTestData> produceB(EmptyESSourceTestRecordB const&) { return make(); }
+    std::auto_ptr<EmptyESSourceTestData> produceC(EmptyESSourceTestRecordC const&) { return make(); }
+
+  private:
+    static std::auto_ptr<EmptyESSourceTestData> make() {
+      std::auto_ptr<EmptyESSourceTestData> data(new EmptyESSourceTestData);
+      data->value_ = 0;
+      return data;
+    }
+  };
+}
+
+EVENTSETUP_RECORD_REG(EmptyESSourceTestRecordA);
+EVENTSETUP_RECORD_REG(EmptyESSourceTestRecordB);
+EVENTSETUP_RECORD_REG(EmptyESSourceTestRecordC);
+TYPELOOKUP_DATA_REG(EmptyESSourceTestData);
+
+using edmtest::EmptyESSourceTestProducer;
+DEFINE_FWK_EVENTSETUP_MODULE(EmptyESSourceTestProducer);
@@ -0,0 +1,100 @@
+// -*- C++ -*-
+//
+// Package:     Modules
+// Class  :     EventAuxiliaryHistoryChecker
+//
+// Implementation:
+//     Test module for EventAuxiliaryHistoryProducer. It reads the std::vector<EventAuxiliary>
+//     product and each of the column products of the same module and checks that the columns
+//     hold the same values in the same order. It also checks the length of the history, which
+//     must restart at 1 each time the EventID is not the one following the previous event.
+//
+
+// system include files
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// user include files
+#include "DataFormats/Provenance/interface/EventAuxiliary.h"
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+namespace edmtest {
+
+  class EventAuxiliaryHistoryChecker : public edm::EDAnalyzer {
+  public:
+    explicit EventAuxiliaryHistoryChecker(edm::ParameterSet const& iPSet) :
+      label_(iPSet.getUntrackedParameter<std::string>("src")),
+      depth_(iPSet.getUntrackedParameter<unsigned int>("historyDepth")),
+      previous_(),
+      expectedSize_(0) {
+    }
+
+  private:
+    virtual void analyze(edm::Event const& iEvent, edm::EventSetup const&) override {
+      if(expectedSize_ != 0 && previous_.next(iEvent.luminosityBlock()) == iEvent.id()) {
+        expectedSize_ = std::min(expectedSize_ + 1, depth_);
+      } else {
+        expectedSize_ = 1;
+      }
+      previous_ = iEvent.id();
+
+      edm::Handle<std::vector<edm::EventAuxiliary> > history;
+      iEvent.getByLabel(edm::InputTag(label_), history);
+      if(history->size() != expectedSize_) {
+        throw cms::Exception("TestFailure") << "EventAuxiliaryHistoryChecker: the history of " << iEvent.id() << " has "
+                                            << history->size() << " entries but " << expectedSize_ << " were expected";
+      }
+      if(history->back().id() != iEvent.id()) {
+        throw cms::Exception("TestFailure") << "EventAuxiliaryHistoryChecker: the history of " << iEvent.id() << " ends with "
+                                            << history->back().id();
+      }
+
+      std::vector<edm::RunNumber_t> runs;
+      std::vector<edm::LuminosityBlockNumber_t> lumis;
+      std::vector<edm::EventNumber_t> events;
+      std::vector<edm::TimeValue_t> times;
+      std::vector<int> bunchCrossings;
+      std::vector<int> orbitNumbers;
+      for(std::vector<edm::EventAuxiliary>::const_iterator it = history->begin(), itEnd = history->end(); it != itEnd; ++it) {
+        runs.push_back(it->run());
+        lumis.push_back(it->luminosityBlock());
+        events.push_back(it->event());
+        times.push_back(it->time().value());
+        bunchCrossings.push_back(it->bunchCrossing());
+        orbitNumbers.push_back(it->orbitNumber());
+      }
+      compare(iEvent, "run", runs);
+      compare(iEvent, "luminosityBlock", lumis);
+      compare(iEvent, "event", events);
+      compare(iEvent, "time", times);
+      compare(iEvent, "bunchCrossing", bunchCrossings);
+      compare(iEvent, "orbitNumber", orbitNumbers);
+    }
+
+    template<typename T>
+    void compare(edm::Event const& iEvent, char const* iColumn, std::vector<T> const& iExpected) const {
+      edm::Handle<std::vector<T> > column;
+      iEvent.getByLabel(edm::InputTag(label_, iColumn), column);
+      if(*column != iExpected) {
+        throw cms::Exception("TestFailure") << "EventAuxiliaryHistoryChecker: the column '" << iColumn << "' of " << iEvent.id()
+                                            << " has " << column->size() << " entries which differ from the " << iExpected.size()
+                                            << " of the EventAuxiliary history";
+      }
+    }
+
+    std::string label_;
+    unsigned int depth_;
+    edm::EventID previous_;
+    unsigned int expectedSize_;
+  };
+}
+
+using edmtest::EventAuxiliaryHistoryChecker;
+DEFINE_FWK_MODULE(EventAuxiliaryHistoryChecker);
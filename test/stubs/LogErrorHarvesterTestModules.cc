@@ -0,0 +1,114 @@
+// -*- C++ -*-
+//
+// Package:     Modules
+// Class  :     LogErrorEmitter, LogErrorHarvesterChecker
+//
+// Implementation:
+//     Test modules for LogErrorHarvester. LogErrorEmitter logs one LogError per entry of
+//     'errorCategories' and one LogWarning per entry of 'warningCategories' for each event.
+//     LogErrorHarvesterChecker compares the entries put by a LogErrorHarvester into the
+//     Event and, optionally, into the LuminosityBlock with the expected ones.
+//
+
+// system include files
+#include <string>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/ErrorSummaryEntry.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+namespace edmtest {
+
+  class LogErrorEmitter : public edm::EDAnalyzer {
+  public:
+    explicit LogErrorEmitter(edm::ParameterSet const& iPSet) :
+      errorCategories_(iPSet.getUntrackedParameter<std::vector<std::string> >("errorCategories")),
+      warningCategories_(iPSet.getUntrackedParameter<std::vector<std::string> >("warningCategories")) {
+    }
+
+  private:
+    virtual void analyze(edm::Event const&, edm::EventSetup const&) override {
+      for(std::vector<std::string>::const_iterator it = errorCategories_.begin(), itEnd = errorCategories_.end(); it != itEnd; ++it) {
+        edm::LogError(*it) << "test error";
+      }
+      for(std::vector<std::string>::const_iterator it = warningCategories_.begin(), itEnd = warningCategories_.end(); it != itEnd; ++it) {
+        edm::LogWarning(*it) << "test warning";
+      }
+    }
+
+    std::vector<std::string> errorCategories_;
+    std::vector<std::string> warningCategories_;
+  };
+
+  class LogErrorHarvesterChecker : public edm::EDAnalyzer {
+  public:
+    explicit LogErrorHarvesterChecker(edm::ParameterSet const& iPSet) :
+      src_(iPSet.getUntrackedParameter<edm::InputTag>("src")),
+      categories_(iPSet.getUntrackedParameter<std::vector<std::string> >("categories")),
+      severities_(iPSet.getUntrackedParameter<std::vector<std::string> >("severities")),
+      counts_(iPSet.getUntrackedParameter<std::vector<unsigned int> >("counts")),
+      lumiSrc_(iPSet.getUntrackedParameter<edm::InputTag>("lumiSrc", edm::InputTag())),
+      lumiCategories_(iPSet.getUntrackedParameter<std::vector<std::string> >("lumiCategories", std::vector<std::string>())),
+      lumiSeverities_(iPSet.getUntrackedParameter<std::vector<std::string> >("lumiSeverities", std::vector<std::string>())),
+      lumiCounts_(iPSet.getUntrackedParameter<std::vector<unsigned int> >("lumiCounts", std::vector<unsigned int>())) {
+    }
+
+  private:
+    virtual void analyze(edm::Event const& iEvent, edm::EventSetup const&) override {
+      edm::Handle<std::vector<edm::ErrorSummaryEntry> > handle;
+      iEvent.getByLabel(src_, handle);
+      compare(*handle, categories_, severities_, counts_, "Event");
+    }
+
+    virtual void endLuminosityBlock(edm::LuminosityBlock const& iLumi, edm::EventSetup const&) override {
+      if(lumiSrc_.label().empty()) {
+        return;
+      }
+      edm::Handle<std::vector<edm::ErrorSummaryEntry> > handle;
+      iLumi.getByLabel(lumiSrc_, handle);
+      compare(*handle, lumiCategories_, lumiSeverities_, lumiCounts_, "LuminosityBlock");
+    }
+
+    static void compare(std::vector<edm::ErrorSummaryEntry> const& iEntries,
+                        std::vector<std::string> const& iCategories,
+                        std::vector<std::string> const& iSeverities,
+                        std::vector<unsigned int> const& iCounts,
+                        char const* iWhere) {
+      if(iEntries.size() != iCategories.size()) {
+        throw cms::Exception("TestFailure") << "LogErrorHarvesterChecker: " << iWhere << " has " << iEntries.size()
+                                            << " entries but " << iCategories.size() << " were expected";
+      }
+      for(unsigned int i = 0; i != iEntries.size(); ++i) {
+        edm::ErrorSummaryEntry const& entry = iEntries[i];
+        if(entry.category != iCategories[i] || entry.severity.getInputStr() != iSeverities[i] || entry.count != iCounts[i]) {
+          throw cms::Exception("TestFailure") << "LogErrorHarvesterChecker: " << iWhere << " entry " << i << " is ("
+                                              << entry.category << ", " << entry.severity.getInputStr() << ", " << entry.count
+                                              << ") but (" << iCategories[i] << ", " << iSeverities[i] << ", " << iCounts[i]
+                                              << ") was expected";
+        }
+      }
+    }
+
+    edm::InputTag src_;
+    std::vector<std::string> categories_;
+    std::vector<std::string> severities_;
+    std::vector<unsigned int> counts_;
+    edm::InputTag lumiSrc_;
+    std::vector<std::string> lumiCategories_;
+    std::vector<std::string> lumiSeverities_;
+    std::vector<unsigned int> lumiCounts_;
+  };
+}
+
+using edmtest::LogErrorEmitter;
+using edmtest::LogErrorHarvesterChecker;
+DEFINE_FWK_MODULE(LogErrorEmitter);
+DEFINE_FWK_MODULE(LogErrorHarvesterChecker);
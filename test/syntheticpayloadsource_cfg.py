@@ -0,0 +1,32 @@
+# Configuration file for SyntheticPayloadSource
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(100)
+)
+
+process.source = cms.Source("SyntheticPayloadSource",
+    numberOfBranches = cms.uint32(3),
+    meanPayloadSize = cms.uint32(50),
+    payloadSizeDistribution = cms.string('exponential'),
+    seed = cms.uint32(42),
+    numberEventsInLuminosityBlock = cms.untracked.uint32(10)
+)
+
+process.Timing = cms.Service("Timing",
+    summaryOnly = cms.untracked.bool(True)
+)
+
+process.preScaler = cms.EDFilter("Prescaler",
+    prescaleFactor = cms.int32(3),
+    prescaleOffset = cms.int32(0)
+)
+
+process.printContent = cms.EDAnalyzer("EventContentAnalyzer")
+
+process.p = cms.Path(process.preScaler*process.printContent)
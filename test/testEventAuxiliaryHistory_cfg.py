@@ -18,12 +18,18 @@ process.aux = cms.EDProducer("EventAuxiliaryHistoryProducer",
     historyDepth = cms.uint32(5)
 )
 
+process.auxColumns = cms.EDProducer("EventAuxiliaryHistoryProducer",
+    historyDepth = cms.uint32(5),
+    storeEventAuxiliary = cms.bool(False),
+    columns = cms.vstring('bunchCrossing', 'orbitNumber', 'time', 'event')
+)
+
 
 process.out = cms.OutputModule("PoolOutputModule",
     fileName = cms.untracked.string('test.root')
 )
 
 
-process.p1 = cms.Path(process.aux)
+process.p1 = cms.Path(process.aux+process.auxColumns)
 
 process.e1 = cms.EndPath(process.out)
@@ -1,4 +1,11 @@
+# Checks the events accepted by Prescaler.
+# With the argument 'reversed' the events of each luminosity block come in reverse
+# order, the hash based selection must then accept the same events.
+
 import FWCore.ParameterSet.Config as cms
+import sys
+
+reverseOrder = 'reversed' in sys.argv
 
 process = cms.Process("TEST")
 
@@ -12,15 +19,83 @@ process.maxEvents = cms.untracked.PSet(
     input = cms.untracked.int32(20)
 )
 
-process.source = cms.Source("EmptySource")
+# run 1, events 1 to 10 in luminosity block 1 and 11 to 20 in luminosity block 2
+if reverseOrder:
+    listFile = open('prescalerreversed.txt', 'w')
+    for lumi in (1, 2):
+        for event in reversed(range(10*lumi - 9, 10*lumi + 1)):
+            listFile.write('1 %d %d\n' % (lumi, event))
+    listFile.close()
+    process.source = cms.Source("EventIDListSource",
+        fileName = cms.untracked.string('prescalerreversed.txt')
+    )
+else:
+    process.source = cms.Source("EmptySource",
+        numberEventsInLuminosityBlock = cms.untracked.uint32(10)
+    )
+
+def checker(events):
+    if reverseOrder:
+        events = sorted(events, key=lambda event: ((event - 1)//10, -event))
+    return cms.EDAnalyzer("EventIDChecker",
+        eventSequence = cms.untracked.VEventID([cms.EventID(1, event) for event in events])
+    )
 
 process.pre1 = cms.EDFilter("Prescaler",
-    prescaleFactor = cms.int32(5)
+    prescaleFactor = cms.int32(5),
+    prescaleOffset = cms.int32(0)
 )
 
 process.pre2 = cms.EDFilter("Prescaler",
-    prescaleFactor = cms.int32(2)
+    prescaleFactor = cms.int32(2),
+    prescaleOffset = cms.int32(0)
+)
+
+# the accepted events only depend on the EventIDs and the seed, not on their order
+process.pre3 = cms.EDFilter("Prescaler",
+    prescaleFactor = cms.int32(4),
+    prescaleOffset = cms.int32(0),
+    useEventIDHash = cms.bool(True),
+    hashSeed = cms.uint32(1234)
+)
+process.check3 = checker([2, 8, 9, 11, 12, 15, 18])
+
+# one in 2 in luminosity block 1 then one in 3 in luminosity block 2, the count goes on across the switch
+process.pre4 = cms.EDFilter("Prescaler",
+    prescaleFactor = cms.int32(1),
+    prescaleOffset = cms.int32(0),
+    prescaleTable = cms.VPSet(
+        cms.PSet(firstRun = cms.uint32(1), firstLuminosityBlock = cms.uint32(1), prescaleFactor = cms.int32(2)),
+        cms.PSet(firstRun = cms.uint32(1), firstLuminosityBlock = cms.uint32(2), prescaleFactor = cms.int32(3))
+    )
+)
+
+process.check4 = checker([2, 4, 6, 8, 10, 12, 15, 18])
+
+# nothing is logged before 'harvester' so the weight is 0 and the probability 0.5,
+# at most 3 of the events drawn in each luminosity block are kept
+process.harvester = cms.EDProducer("LogErrorHarvester")
+
+process.sampler = cms.EDFilter("SamplingFilter",
+    harvesterTag = cms.InputTag("harvester"),
+    thresholds = cms.vdouble(1.),
+    acceptProbabilities = cms.vdouble(0.5, 1.),
+    maxAcceptedPerLuminosityBlock = cms.uint32(3)
+)
+
+process.checkSampler = checker([1, 6, 7, 15, 18])
+
+# one error is logged before 'harvesterWithError' so the weight is 1 and all events are
+# drawn, the cap keeps the first 3 of each luminosity block
+process.emitError = cms.EDAnalyzer("LogErrorEmitter",
+    errorCategories = cms.untracked.vstring("SamplerTest"),
+    warningCategories = cms.untracked.vstring()
+)
+process.harvesterWithError = cms.EDProducer("LogErrorHarvester")
+process.samplerWithError = process.sampler.clone(
+    harvesterTag = cms.InputTag("harvesterWithError")
 )
+process.checkSamplerWithError = checker([1, 2, 3, 11, 12, 13])
 
 process.print1 = cms.OutputModule("AsciiOutputModule")
 
@@ -32,6 +107,16 @@ process.print2 = cms.OutputModule("AsciiOutputModule",
 
 process.p1 = cms.Path(process.pre1)
 process.p2 = cms.Path(process.pre2)
+process.p3 = cms.Path(process.pre3+process.check3)
+# counting and the per luminosity block cap depend on the order of the events
+if reverseOrder:
+    process.p4 = cms.Path(process.pre4)
+    process.p5 = cms.Path(process.harvester+process.sampler)
+    process.p6 = cms.Path(process.emitError+process.harvesterWithError+process.samplerWithError)
+else:
+    process.p4 = cms.Path(process.pre4+process.check4)
+    process.p5 = cms.Path(process.harvester+process.sampler+process.checkSampler)
+    process.p6 = cms.Path(process.emitError+process.harvesterWithError+process.samplerWithError+process.checkSamplerWithError)
 
 process.e1 = cms.EndPath(process.print1)
 process.e2 = cms.EndPath(process.print2)
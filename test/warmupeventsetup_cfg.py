@@ -0,0 +1,32 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("Demo")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(3)
+)
+
+process.MessageLogger = cms.Service("MessageLogger")
+
+process.WhatsItESProducer = cms.ESProducer("WhatsItESProducer")
+
+process.DoodadESSource = cms.ESSource("DoodadESSource")
+
+process.warmUp = cms.EDAnalyzer("EventSetupRecordDataGetter",
+                              toGet = cms.VPSet(),
+                              warmUp = cms.untracked.bool(True)
+)
+
+# GadgetRcd is named in 'toGet' with only one of its data items, the warm-up still gets them all
+process.warmUpWithToGet = cms.EDAnalyzer("EventSetupRecordDataGetter",
+                              toGet = cms.VPSet(cms.PSet(record = cms.string("GadgetRcd"),
+                                                         data = cms.vstring("edmtest::WhatsIt"))),
+                              verbose = cms.untracked.bool(True),
+                              warmUp = cms.untracked.bool(True)
+)
+
+process.p = cms.Path(process.warmUp+process.warmUpWithToGet)